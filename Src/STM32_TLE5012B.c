@@ -3,10 +3,58 @@
 #include "gpio.h"
 #include "main.h"
 #include "spi.h"
-#include "usart.h"
+
+#ifdef TLE5012_BUS_ARBITRATION
+#include "cmsis_os.h"
+#endif
 
 // keeps track of the values stored in the 8 _registers, for which the crc is calculated
 uint16_t _registers[CRC_NUM_REGISTERS];
+// 1 once _registers holds the configuration read by readBlockCRC()
+uint8_t _registersValid = 0;
+
+// chip reset state: reset seen in a safety word and not handled yet, restore in progress,
+// failed restores in a row, reads left before the next attempt, counters
+uint8_t        _chipResetPending = 0;
+uint8_t        _chipRestoring = 0;
+uint8_t        _chipRestoreRetries = 0;
+uint16_t       _chipRestoreBackoff = 0;
+chipResetStats _chipResetStats;
+
+// fast read mode state: enable flag, reads left until the next audit
+uint8_t       _fastReadEnabled = 0;
+uint16_t      _fastReadsUntilAudit = TLE5012_FAST_READ_AUDIT_PERIOD;
+fastReadStats _fastReadStats;
+
+// adaptive sampling settings and state: 1 while the shaft is stationary, count of stationary samples, current period, last angle
+adaptiveSamplingConfig _adaptiveConfig = {
+    TLE5012_ADAPTIVE_ACTIVE_PERIOD,
+    TLE5012_ADAPTIVE_IDLE_PERIOD,
+    TLE5012_ADAPTIVE_ENTER_IDLE_SPEED,
+    TLE5012_ADAPTIVE_EXIT_IDLE_SPEED,
+    TLE5012_ADAPTIVE_ANGLE_DEADBAND,
+    TLE5012_ADAPTIVE_IDLE_SAMPLES,
+};
+uint8_t  _adaptiveIdle = 0;
+uint16_t _adaptiveStationary = 0;
+uint16_t _adaptivePeriod = TLE5012_ADAPTIVE_ACTIVE_PERIOD;
+int16_t  _adaptiveLastAngle = 0;
+
+// multi-turn position state: 1 once the counter is seeded, last 9 bit revolution counter read, revolutions extended to 32 bits
+uint8_t _multiTurnValid = 0;
+int16_t _multiTurnLastRev = 0;
+int32_t _multiTurnRevolutions = 0;
+
+#ifdef TLE5012_BUS_ARBITRATION
+// shared bus state: owner flag, owning task and its nesting depth, FIFO of the waiting tasks per priority, contention counters
+uint8_t      _busOwned = 0;
+osThreadId_t _busOwner = NULL;
+uint8_t      _busDepth = 0;
+osThreadId_t _busQueue[BUS_NUM_PRIORITIES][TLE5012_BUS_QUEUE_DEPTH];
+uint8_t      _busQueueHead[BUS_NUM_PRIORITIES];
+uint8_t      _busQueueCount[BUS_NUM_PRIORITIES];
+busStats     _busStats;
+#endif
 
 /**
  * Gets the first byte of a 2 byte word
@@ -65,36 +113,199 @@ uint8_t _crcCalc(uint8_t *crcData, uint8_t length)
 }
 
 /**
- * Triggers an update
+ * Gets the bus priority of a command from the register it accesses.
+ * The angle value, speed and revolutions are used by the control loop, status, temperature and raw values are diagnostics,
+ * and everything else is configuration.
  */
-void triggerUpdate(void)
+busPriority _commandPriority(uint16_t command)
 {
-    // SCK LOW
-    HAL_GPIO_WritePin(TLE5012_SCK_GPIO_Port, TLE5012_SCK_Pin, GPIO_PIN_RESET);
-    // MOSI HIGH
-    HAL_GPIO_WritePin(TLE5012_MOSI_GPIO_Port, TLE5012_MOSI_Pin, GPIO_PIN_SET);
-    SPI_CS_ENABLE;
-    HAL_Delay(DELAYuS);
-    SPI_CS_DISABLE;
+    uint16_t address = (command & CMD_ADDRESS_MASK) >> CMD_ADDRESS_SHIFT;
+
+    if (address >= FAST_READ_FIRST_ADDRESS && address < FAST_READ_FIRST_ADDRESS + FAST_READ_NUM_REGISTERS)
+    {
+        return BUS_PRIORITY_CONTROL;
+    }
+
+    else if (address < FAST_READ_FIRST_ADDRESS || command == READ_TEMP_CMD || command == READ_RAW_X_CMD || command == READ_RAW_Y_CMD)
+    {
+        return BUS_PRIORITY_DIAGNOSTIC;
+    }
+
+    else
+    {
+        return BUS_PRIORITY_CONFIG;
+    }
 }
 
-//when an error occurs in the safety word, the error bit remains 0(error), until the status register is read again.
-//flushes out safety errors, that might have occured by reading the register without a safety word.
-void resetSafety(void)
+#ifdef TLE5012_BUS_ARBITRATION
+
+/**
+ * Waits until the shared bus is free. The bus is only held for the CS window of one transaction,
+ * and the critical sections only cover the bookkeeping, so a waiting control loop read gets the bus
+ * as soon as the current transaction ends, before any waiting diagnostic or configuration read.
+ * Calls from the task that already owns the bus only count the nesting depth, so a sequence of transactions
+ * that must not be interleaved with other tasks is wrapped in busAcquire() / busRelease().
+ * Must be called from a task, the tasks waiting for the bus are blocked on TLE5012_BUS_GRANT_FLAG.
+ */
+void busAcquire(busPriority priority)
 {
-    uint16_t u16RegValue = 0;
+    osThreadId_t self      = osThreadGetId();
+    uint32_t     startTick = osKernelGetTickCount();
+    uint8_t      contended = 0;
 
-    triggerUpdate();
+    for (;;)
+    {
+        TLE5012_CRITICAL_ENTER();
 
+        if (_busOwned && _busOwner == self)
+        {
+            _busDepth++;
+            TLE5012_CRITICAL_EXIT();
+            return;
+        }
+
+        if (!_busOwned)
+        {
+            _busOwned = 1;
+            _busOwner = self;
+            _busDepth = 1;
+            _busStats.transactions[priority]++;
+            TLE5012_CRITICAL_EXIT();
+            return;
+        }
+
+        contended = 1;
+
+        if (_busQueueCount[priority] < TLE5012_BUS_QUEUE_DEPTH)
+        {
+            uint8_t tail = (_busQueueHead[priority] + _busQueueCount[priority]) % TLE5012_BUS_QUEUE_DEPTH;
+            _busQueue[priority][tail] = self;
+            _busQueueCount[priority]++;
+            TLE5012_CRITICAL_EXIT();
+            break;
+        }
+
+        // block instead of yielding, a yield would not let a lower priority owner run and release the bus
+        _busStats.queueFull[priority]++;
+        TLE5012_CRITICAL_EXIT();
+        osDelay(1);
+    }
+
+    // busRelease() hands the bus over without clearing _busOwned, and already makes this task the owner
+    osThreadFlagsWait(TLE5012_BUS_GRANT_FLAG, osFlagsWaitAny, osWaitForever);
+
+    uint32_t waited = osKernelGetTickCount() - startTick;
+
+    TLE5012_CRITICAL_ENTER();
+    _busStats.transactions[priority]++;
+    _busStats.contended[priority] += contended;
+    _busStats.waitTicks[priority] += waited;
+
+    if (waited > _busStats.maxWaitTicks[priority])
+    {
+        _busStats.maxWaitTicks[priority] = waited;
+    }
+
+    TLE5012_CRITICAL_EXIT();
+}
+
+/**
+ * Ends the outermost busAcquire() of the owning task: hands the bus over to the first waiting task of the highest priority,
+ * or frees it if nobody is waiting.
+ */
+void busRelease(void)
+{
+    osThreadId_t next = NULL;
+
+    TLE5012_CRITICAL_ENTER();
+
+    if (--_busDepth > 0)
+    {
+        TLE5012_CRITICAL_EXIT();
+        return;
+    }
+
+    for (uint16_t priority = 0; priority < BUS_NUM_PRIORITIES; priority++)
+    {
+        if (_busQueueCount[priority] > 0)
+        {
+            next = _busQueue[priority][_busQueueHead[priority]];
+            _busQueueHead[priority] = (_busQueueHead[priority] + 1) % TLE5012_BUS_QUEUE_DEPTH;
+            _busQueueCount[priority]--;
+            break;
+        }
+    }
+
+    if (next == NULL)
+    {
+        _busOwned = 0;
+    }
+
+    _busOwner = next;
+    _busDepth = (next != NULL) ? 1 : 0;
+
+    TLE5012_CRITICAL_EXIT();
+
+    if (next != NULL)
+    {
+        osThreadFlagsSet(next, TLE5012_BUS_GRANT_FLAG);
+    }
+}
+
+void getBusStats(busStats *stats)
+{
+    TLE5012_CRITICAL_ENTER();
+    *stats = _busStats;
+    TLE5012_CRITICAL_EXIT();
+}
+
+/**
+ * Gives the MOSI pin back to the SPI peripheral before releasing the bus, so the other devices can transmit.
+ */
+void _busReleaseSpi(void)
+{
+#ifndef TLE5012_NOT_MODIFY_MOSI_MANUALLY
+    GPIO_InitTypeDef GPIO_InitStruct = { 0 };
+
+    TLE5012_SET_MOSI_MODE_AF_PP();
+#endif
+
+    busRelease();
+}
+
+#endif
+
+/**
+ * Triggers an update, holding the bus with the priority of the caller
+ */
+void _triggerUpdate(busPriority priority)
+{
+    (void)priority; // only used by the bus arbitration
+
+    TLE5012_BUS_ACQUIRE(priority);
+
+    // SCK LOW
+    HAL_GPIO_WritePin(TLE5012_SCK_GPIO_Port, TLE5012_SCK_Pin, GPIO_PIN_RESET);
+    // MOSI HIGH
+    HAL_GPIO_WritePin(TLE5012_MOSI_GPIO_Port, TLE5012_MOSI_Pin, GPIO_PIN_SET);
     SPI_CS_ENABLE;
 
-    u16RegValue = READ_STA_CMD;
-    HAL_SPI_Transmit(TLE5012_SPI, (uint8_t *)(&u16RegValue), sizeof(u16RegValue) / sizeof(uint16_t), 0xFF);
-    u16RegValue = DUMMY;
-    HAL_SPI_Transmit(TLE5012_SPI, (uint8_t *)(&u16RegValue), sizeof(u16RegValue) / sizeof(uint16_t), 0xFF);
-    HAL_SPI_Transmit(TLE5012_SPI, (uint8_t *)(&u16RegValue), sizeof(u16RegValue) / sizeof(uint16_t), 0xFF);
+    // short busy-wait instead of HAL_Delay(), which waits at least one tick and would make every audit a millisecond long
+    for (volatile uint16_t pulse = 0; pulse < TLE5012_UPDATE_PULSE_LOOPS; pulse++)
+    {
+    }
 
     SPI_CS_DISABLE;
+
+    TLE5012_BUS_RELEASE();
+}
+
+/**
+ * Triggers an update
+ */
+void triggerUpdate(void)
+{
+    _triggerUpdate(BUS_PRIORITY_CONTROL);
 }
 
 /**
@@ -111,10 +322,22 @@ void resetSafety(void)
  * and needs to be checked with the CRC sent in the safety word.
  */
 
-errorTypes checkSafety(uint16_t safety, uint16_t command, uint16_t *readreg, uint16_t length)
+errorTypes _checkSafetyWord(uint16_t safety, uint16_t command, uint16_t *readreg, uint16_t length)
 {
     errorTypes errorCheck;
 
+    // the reset bit does not make the value invalid, it is handled after the transaction by _handleChipReset().
+    // It stays set until the configuration is restored, so a reset is only counted once
+    if (!((safety)&CHIP_RESET_MASK))
+    {
+        if (!_chipResetPending)
+        {
+            _chipResetStats.resets++;
+        }
+
+        _chipResetPending = 1;
+    }
+
     if (!((safety)&SYSTEM_ERROR_MASK))
     {
         errorCheck = SYSTEM_ERROR;
@@ -155,13 +378,269 @@ errorTypes checkSafety(uint16_t safety, uint16_t command, uint16_t *readreg, uin
         else
         {
             errorCheck = CRC_ERROR;
-            resetSafety();
         }
     }
 
     return errorCheck;
 }
 
+//when an error occurs in the safety word, the error bit remains 0(error), until the status register is read again.
+//flushes out safety errors, that might have occured by reading the register without a safety word.
+//The safety word of the status read is checked like any other one, so a reset or an error latched since the last
+//checked read is reported instead of being flushed silently.
+errorTypes resetSafety(void)
+{
+    uint16_t         u16RegValue     = 0;
+    uint16_t         readreg         = 0;
+    uint16_t         safety          = 0;
+    GPIO_InitTypeDef GPIO_InitStruct = { 0 };
+
+    _triggerUpdate(BUS_PRIORITY_DIAGNOSTIC);
+
+    TLE5012_BUS_ACQUIRE(BUS_PRIORITY_DIAGNOSTIC);
+
+    SPI_CS_ENABLE;
+
+    u16RegValue = READ_STA_CMD;
+
+#ifndef TLE5012_NOT_MODIFY_MOSI_MANUALLY
+    TLE5012_SET_MOSI_MODE_AF_PP();
+#endif
+
+    HAL_SPI_Transmit(TLE5012_SPI, (uint8_t *)(&u16RegValue), sizeof(u16RegValue) / sizeof(uint16_t), 0xFF);
+
+#ifndef TLE5012_NOT_MODIFY_MOSI_MANUALLY
+    TLE5012_SET_MOSI_MODE_INPUT();
+#endif
+
+    HAL_SPI_Receive(TLE5012_SPI, (uint8_t *)(&readreg), 1, 0xFF);
+    HAL_SPI_Receive(TLE5012_SPI, (uint8_t *)(&safety), 1, 0xFF);
+
+    SPI_CS_DISABLE;
+
+    TLE5012_BUS_RELEASE();
+
+    // not checkSafety(), a CRC error would call resetSafety() again
+    return _checkSafetyWord(safety, READ_STA_CMD, &readreg, 1);
+}
+
+/**
+ * Checks the safety word of a transaction, see _checkSafetyWord(). A CRC error also flushes the safety errors with resetSafety().
+ */
+errorTypes checkSafety(uint16_t safety, uint16_t command, uint16_t *readreg, uint16_t length)
+{
+    errorTypes errorCheck = _checkSafetyWord(safety, command, readreg, length);
+
+    if (errorCheck == CRC_ERROR)
+    {
+        resetSafety();
+    }
+
+    return errorCheck;
+}
+
+/**
+ * Reads the block of _registers from addresses 08 - 0F into registers.
+ */
+errorTypes _readBlock(uint16_t *registers)
+{
+    uint16_t         u16RegValue     = 0;
+    uint16_t         safety          = 0;
+    GPIO_InitTypeDef GPIO_InitStruct = { 0 };
+
+    TLE5012_BUS_ACQUIRE(BUS_PRIORITY_CONFIG);
+
+    SPI_CS_ENABLE;
+
+#ifndef TLE5012_NOT_MODIFY_MOSI_MANUALLY
+    TLE5012_SET_MOSI_MODE_AF_PP();
+#endif
+
+    u16RegValue = READ_BLOCK_CRC;
+    HAL_SPI_Transmit(TLE5012_SPI, (uint8_t *)(&u16RegValue), sizeof(u16RegValue) / sizeof(uint16_t), 0xFFFF);
+
+#ifndef TLE5012_NOT_MODIFY_MOSI_MANUALLY
+    TLE5012_SET_MOSI_MODE_INPUT();
+#endif
+
+    HAL_SPI_Receive(TLE5012_SPI, (uint8_t *)registers, CRC_NUM_REGISTERS, 0xFF);
+    HAL_SPI_Receive(TLE5012_SPI, (uint8_t *)(&safety), 1, 0xFF);
+
+    SPI_CS_DISABLE;
+
+    TLE5012_BUS_RELEASE();
+
+    return checkSafety(safety, READ_BLOCK_CRC, registers, CRC_NUM_REGISTERS);
+}
+
+/**
+ * General write function: sends the command followed by length data words, the safety word comes after the data.
+ */
+errorTypes writeToSensor(uint16_t command, uint16_t *data, uint16_t length)
+{
+    uint16_t         u16RegValue     = 0;
+    uint16_t         safety          = 0;
+    GPIO_InitTypeDef GPIO_InitStruct = { 0 };
+
+    TLE5012_BUS_ACQUIRE(_commandPriority(command));
+
+    SPI_CS_ENABLE;
+
+#ifndef TLE5012_NOT_MODIFY_MOSI_MANUALLY
+    TLE5012_SET_MOSI_MODE_AF_PP();
+#endif
+
+    u16RegValue = command;
+    HAL_SPI_Transmit(TLE5012_SPI, (uint8_t *)(&u16RegValue), sizeof(u16RegValue) / sizeof(uint16_t), 0xFF);
+    HAL_SPI_Transmit(TLE5012_SPI, (uint8_t *)data, length, 0xFF);
+
+#ifndef TLE5012_NOT_MODIFY_MOSI_MANUALLY
+    TLE5012_SET_MOSI_MODE_INPUT();
+#endif
+
+    HAL_SPI_Receive(TLE5012_SPI, (uint8_t *)(&safety), 1, 0xFF);
+
+    SPI_CS_DISABLE;
+
+    TLE5012_BUS_RELEASE();
+
+    return checkSafety(safety, command, data, length);
+}
+
+/**
+ * After a chip reset the configuration _registers are back to their default values.
+ * The whole image read by readBlockCRC() is written back in a single transaction, then one block read checks that every
+ * register, including the CRC in TEMP_COEFF, holds the value written. Reading the status register afterwards clears the reset bit.
+ * Only one task restores at a time, and it holds the bus for the whole sequence; a concurrent call returns CHIP_RESET_ERROR.
+ */
+errorTypes restoreConfiguration(void)
+{
+    uint16_t verify[CRC_NUM_REGISTERS];
+
+    if (!_registersValid)
+    {
+        return CRC_ERROR;
+    }
+
+    TLE5012_CRITICAL_ENTER();
+    uint8_t restoring = _chipRestoring;
+    _chipRestoring = 1;
+    TLE5012_CRITICAL_EXIT();
+
+    if (restoring)
+    {
+        return CHIP_RESET_ERROR;
+    }
+
+    TLE5012_BUS_ACQUIRE(BUS_PRIORITY_CONFIG);
+
+    errorTypes checkError = writeToSensor(WRITE_BLOCK_CRC, _registers, CRC_NUM_REGISTERS);
+
+    if (checkError == NO_ERROR)
+    {
+        checkError = _readBlock(verify);
+    }
+
+    if (checkError == NO_ERROR)
+    {
+        for (uint16_t i = 0; i < CRC_NUM_REGISTERS; i++)
+        {
+            if (verify[i] != _registers[i])
+            {
+                checkError = CRC_ERROR;
+            }
+        }
+    }
+
+    // its safety word still reports the reset being handled, the pending flag is cleared below
+    if (checkError == NO_ERROR)
+    {
+        resetSafety();
+    }
+
+    TLE5012_BUS_RELEASE();
+
+    if (checkError == NO_ERROR)
+    {
+        TLE5012_CRITICAL_ENTER();
+        _chipResetPending = 0;
+        _chipRestoreRetries = 0;
+        _chipRestoreBackoff = 0;
+        _chipResetStats.restores++;
+        _chipRestoring = 0;
+        TLE5012_CRITICAL_EXIT();
+    }
+    else
+    {
+        // the reset stays pending: the restore is tried again after the next checked transaction,
+        // or after TLE5012_RESTORE_BACKOFF_READS of them once it failed TLE5012_RESTORE_MAX_RETRIES times in a row
+        TLE5012_CRITICAL_ENTER();
+        _chipResetStats.restoreFailures++;
+
+        if (++_chipRestoreRetries >= TLE5012_RESTORE_MAX_RETRIES)
+        {
+            _chipRestoreRetries = TLE5012_RESTORE_MAX_RETRIES;
+            _chipRestoreBackoff = TLE5012_RESTORE_BACKOFF_READS;
+        }
+
+        _chipRestoring = 0;
+        TLE5012_CRITICAL_EXIT();
+    }
+
+    return checkError;
+}
+
+/**
+ * Called after each checked transaction: restores the configuration after a reset reported by the safety word,
+ * and returns the error of the restore so the caller does not use values from a sensor left in its default configuration.
+ * While another task restores, or while the restore is backing off after repeated failures, the read fails with
+ * CHIP_RESET_ERROR without any transaction.
+ * Without a configuration to restore, reading the status register clears the reset bit.
+ */
+errorTypes _handleChipReset(void)
+{
+    TLE5012_CRITICAL_ENTER();
+
+    uint8_t  pending   = _chipResetPending;
+    uint8_t  restoring = _chipRestoring;
+    uint16_t backoff   = _chipRestoreBackoff;
+
+    if (pending && !restoring && backoff > 0)
+    {
+        _chipRestoreBackoff--;
+        _chipResetStats.restoresSkipped++;
+    }
+
+    TLE5012_CRITICAL_EXIT();
+
+    if (!pending)
+    {
+        return NO_ERROR;
+    }
+
+    if (restoring || backoff > 0)
+    {
+        return CHIP_RESET_ERROR;
+    }
+
+    if (_registersValid)
+    {
+        return restoreConfiguration();
+    }
+
+    resetSafety();
+    _chipResetPending = 0;
+
+    return NO_ERROR;
+}
+
+void getChipResetStats(chipResetStats *stats)
+{
+    TLE5012_CRITICAL_ENTER();
+    *stats = _chipResetStats;
+    TLE5012_CRITICAL_EXIT();
+}
+
 /**
  * General read function for reading _registers from the Tle5012b_4wire.
  * Command[in]  -- the command for reading
@@ -183,6 +662,8 @@ errorTypes readFromSensor(uint16_t command, uint16_t *data)
     uint16_t         u16RegValue     = 0;
     GPIO_InitTypeDef GPIO_InitStruct = { 0 };
 
+    TLE5012_BUS_ACQUIRE(_commandPriority(command));
+
     SPI_CS_ENABLE;
 
     u16RegValue = command;
@@ -202,7 +683,15 @@ errorTypes readFromSensor(uint16_t command, uint16_t *data)
 
     SPI_CS_DISABLE;
 
+    TLE5012_BUS_RELEASE();
+
     errorTypes checkError = checkSafety(safety, command, &readreg, 1);
+    errorTypes resetError = _handleChipReset();
+
+    if (checkError == NO_ERROR)
+    {
+        checkError = resetError;
+    }
 
     if (checkError != NO_ERROR)
     {
@@ -217,31 +706,196 @@ errorTypes readFromSensor(uint16_t command, uint16_t *data)
 }
 
 /**
- * Reads the block of _registers from addresses 08 - 0F in order to figure out the CRC.
+ * Reads a register without the safety word: the transfer is ended by releasing CS right after the data word.
+ * This shortens the frame by one word, but the value received can not be checked, so it is only used by the fast read path.
  */
-errorTypes readBlockCRC(void)
+void readFromSensorNoSafety(uint16_t command, uint16_t *data)
 {
-    uint16_t u16RegValue = 0;
-    uint16_t         safety          = 0;
+    uint16_t         readreg         = 0;
+    uint16_t         u16RegValue     = 0;
     GPIO_InitTypeDef GPIO_InitStruct = { 0 };
 
+    TLE5012_BUS_ACQUIRE(_commandPriority(command));
+
     SPI_CS_ENABLE;
 
+    u16RegValue = command;
+
 #ifndef TLE5012_NOT_MODIFY_MOSI_MANUALLY
     TLE5012_SET_MOSI_MODE_AF_PP();
 #endif
 
-    u16RegValue = READ_BLOCK_CRC;
-    HAL_SPI_Transmit(TLE5012_SPI, (uint8_t *)(&u16RegValue), sizeof(u16RegValue) / sizeof(uint16_t), 0xFFFF);
+    HAL_SPI_Transmit(TLE5012_SPI, (uint8_t *)(&u16RegValue), sizeof(u16RegValue) / sizeof(uint16_t), 0xFF);
 
 #ifndef TLE5012_NOT_MODIFY_MOSI_MANUALLY
     TLE5012_SET_MOSI_MODE_INPUT();
 #endif
 
-    HAL_SPI_Receive(TLE5012_SPI, (uint8_t *)(&_registers), CRC_NUM_REGISTERS, 0xFF);
-    HAL_SPI_Receive(TLE5012_SPI, (uint8_t *)(&safety), 1, 0xFF);
+    HAL_SPI_Receive(TLE5012_SPI, (uint8_t *)(&readreg), 1, 0xFF);
+
+    SPI_CS_DISABLE;
 
-    errorTypes checkError = checkSafety(safety, READ_BLOCK_CRC, _registers, CRC_NUM_REGISTERS);
+    TLE5012_BUS_RELEASE();
+
+    *data = readreg;
+}
+
+/**
+ * Distance between two raw values of a register, taking the wrap around of the signed field given by mask into account.
+ */
+uint16_t _rawDistance(uint16_t a, uint16_t b, uint16_t mask)
+{
+    uint16_t distance = (uint16_t)(a - b) & mask;
+
+    if (distance > (mask >> 1))
+    {
+        distance = (uint16_t)(mask + 1 - distance);
+    }
+
+    return distance;
+}
+
+/**
+ * Read function used for the angle value, speed and revolution registers.
+ * When the fast read mode is off, this is the same as readFromSensor().
+ * When it is on, the registers are read without safety word, and every TLE5012_FAST_READ_AUDIT_PERIOD reads
+ * the read is replaced by an audit: an update is triggered (by resetSafety(), which also reads the safety errors
+ * latched during the reads without safety word and fails the audit on any of them), then the update buffer of the
+ * register is read once without and once with the safety word. Both reads return the same sample, so they must be equal even while the shaft moves.
+ * A safety error or two different values turn the fast read mode off,
+ * so a bus fault is detected after at most TLE5012_FAST_READ_AUDIT_PERIOD reads.
+ */
+errorTypes readFastFromSensor(uint16_t command, uint16_t *data)
+{
+    uint16_t index      = ((command & CMD_ADDRESS_MASK) >> CMD_ADDRESS_SHIFT) - FAST_READ_FIRST_ADDRESS;
+    uint16_t updCommand = command | CHECK_CMD_UPDATE;
+    uint16_t fastValue  = 0;
+
+    uint8_t  audit      = 0;
+
+    if (index >= FAST_READ_NUM_REGISTERS)
+    {
+        return readFromSensor(command, data);
+    }
+
+    // the counters are shared by all the tasks reading in fast mode
+    TLE5012_CRITICAL_ENTER();
+
+    uint8_t enabled = _fastReadEnabled;
+
+    if (enabled && _fastReadsUntilAudit > 0)
+    {
+        _fastReadsUntilAudit--;
+        _fastReadStats.fastReads++;
+    }
+    else if (enabled)
+    {
+        _fastReadsUntilAudit = TLE5012_FAST_READ_AUDIT_PERIOD;
+        _fastReadStats.audits++;
+        audit = 1;
+    }
+
+    TLE5012_CRITICAL_EXIT();
+
+    if (!enabled)
+    {
+        return readFromSensor(command, data);
+    }
+
+    if (!audit)
+    {
+        readFromSensorNoSafety(command, data);
+        return NO_ERROR;
+    }
+
+    // the update and both reads of the audit must see the same sample, so no other task may use the bus in between
+    TLE5012_BUS_ACQUIRE(_commandPriority(command));
+
+    errorTypes checkError = resetSafety();
+
+    if (checkError == NO_ERROR)
+    {
+        readFromSensorNoSafety(updCommand, &fastValue);
+        checkError = readFromSensor(updCommand, data);
+    }
+
+    TLE5012_BUS_RELEASE();
+
+    if (checkError == NO_ERROR && *data != fastValue)
+    {
+        *data = 0;
+        checkError = FAST_READ_AUDIT_ERROR;
+    }
+
+    if (checkError != NO_ERROR)
+    {
+        TLE5012_CRITICAL_ENTER();
+
+        if (checkError == FAST_READ_AUDIT_ERROR)
+        {
+            _fastReadStats.auditMismatches++;
+        }
+        else
+        {
+            _fastReadStats.auditErrors++;
+        }
+
+        _fastReadEnabled = 0;
+        TLE5012_CRITICAL_EXIT();
+    }
+
+    return checkError;
+}
+
+/**
+ * Enables or disables the fast read mode. Enabling it starts with a full audit period.
+ */
+void setFastReadMode(uint8_t enable)
+{
+    TLE5012_CRITICAL_ENTER();
+    _fastReadsUntilAudit = TLE5012_FAST_READ_AUDIT_PERIOD;
+    _fastReadEnabled = enable ? 1 : 0;
+    TLE5012_CRITICAL_EXIT();
+}
+
+uint8_t getFastReadMode(void)
+{
+    return _fastReadEnabled;
+}
+
+void getFastReadStats(fastReadStats *stats)
+{
+    TLE5012_CRITICAL_ENTER();
+    *stats = _fastReadStats;
+    TLE5012_CRITICAL_EXIT();
+}
+
+/**
+ * Reads the block of _registers from addresses 08 - 0F in order to figure out the CRC.
+ * If the chip was reset, the _registers read earlier are kept and written back instead of being replaced by the default values.
+ */
+errorTypes readBlockCRC(void)
+{
+    uint16_t registers[CRC_NUM_REGISTERS];
+
+    errorTypes checkError = _readBlock(registers);
+
+    if (_chipResetPending && _registersValid)
+    {
+        return _handleChipReset();
+    }
+
+    _handleChipReset();
+
+    if (checkError == NO_ERROR)
+    {
+        for (uint16_t i = 0; i < CRC_NUM_REGISTERS; i++)
+        {
+            _registers[i] = registers[i];
+        }
+
+        _registersValid = 1;
+    }
 
     return checkError;
 }
@@ -249,7 +903,7 @@ errorTypes readBlockCRC(void)
 errorTypes readAngleValue(int16_t *data)
 {
     uint16_t rawData = 0;
-    errorTypes status = readFromSensor(READ_ANGLE_VAL_CMD, &rawData);
+    errorTypes status = readFastFromSensor(READ_ANGLE_VAL_CMD, &rawData);
 
     if (status != NO_ERROR)
     {
@@ -275,7 +929,7 @@ errorTypes readAngleValue(int16_t *data)
 errorTypes readAngleSpeed(int16_t *data)
 {
     uint16_t rawData = 0;
-    errorTypes status = readFromSensor(READ_ANGLE_SPD_CMD, &rawData);
+    errorTypes status = readFastFromSensor(READ_ANGLE_SPD_CMD, &rawData);
 
     if (status != NO_ERROR)
     {
@@ -297,7 +951,7 @@ errorTypes readAngleSpeed(int16_t *data)
 errorTypes readUpdAngleValue(int16_t *data)
 {
     uint16_t rawData = 0;
-    errorTypes status = readFromSensor(READ_UPD_ANGLE_VAL_CMD, &rawData);
+    errorTypes status = readFastFromSensor(READ_UPD_ANGLE_VAL_CMD, &rawData);
 
     if (status != NO_ERROR)
     {
@@ -320,7 +974,7 @@ errorTypes readUpdAngleValue(int16_t *data)
 errorTypes readUpdAngleSpeed(int16_t *data)
 {
     uint16_t rawData = 0;
-    errorTypes status = readFromSensor(READ_UPD_ANGLE_SPD_CMD, &rawData);
+    errorTypes status = readFastFromSensor(READ_UPD_ANGLE_SPD_CMD, &rawData);
 
     if (status != NO_ERROR)
     {
@@ -345,7 +999,7 @@ errorTypes readUpdAngleRevolution(int16_t *data)
 {
     uint16_t rawData = 0;
 
-    errorTypes status = readFromSensor(READ_UPD_ANGLE_REV_CMD, &rawData);
+    errorTypes status = readFastFromSensor(READ_UPD_ANGLE_REV_CMD, &rawData);
 
     if (status != NO_ERROR)
     {
@@ -372,7 +1026,7 @@ errorTypes readUpdAngleRevolution(int16_t *data)
 errorTypes readAngleRevolution(int16_t *data)
 {
     uint16_t rawData = 0;
-    errorTypes status = readFromSensor(READ_ANGLE_REV_CMD, &rawData);
+    errorTypes status = readFastFromSensor(READ_ANGLE_REV_CMD, &rawData);
 
     if (status != NO_ERROR)
     {
@@ -419,6 +1073,19 @@ errorTypes readTemp(int16_t *data)
     return NO_ERROR;
 }
 
+/**
+ * The raw X and Y values of the GMR bridges are 16 bit signed integers, their amplitude shows the strength of the magnet.
+ */
+errorTypes readRawX(int16_t *data)
+{
+    return readFromSensor(READ_RAW_X_CMD, (uint16_t *)data);
+}
+
+errorTypes readRawY(int16_t *data)
+{
+    return readFromSensor(READ_RAW_Y_CMD, (uint16_t *)data);
+}
+
 errorTypes readIntMode1(uint16_t *data)
 {
     return readFromSensor(READ_INTMODE_1, data);
@@ -621,6 +1288,96 @@ errorTypes getUpdNumRevolutions(int16_t *numRev)
     return readUpdAngleRevolution(numRev);
 }
 
+/**
+ * The number of revolutions is read before and after the angle value: when both are equal the angle belongs to that turn,
+ * otherwise the angle wrapped during the reads and it is read again. The three reads hold the bus, so another task can not
+ * trigger an update in between.
+ * The counter of the sensor only has 9 bits and wraps from +255 to -256 turns, so it is extended in software from the
+ * difference with the previous call: the shaft must turn less than 256 revolutions between two calls.
+ * The reads may restore the configuration after a chip reset or audit the fast read mode, so this is for tasks only:
+ * a call from an interrupt returns CONTEXT_ERROR.
+ */
+errorTypes getMultiTurnPosition(int32_t *position)
+{
+    int16_t rawAngleValue = 0;
+    int16_t numRev        = 0;
+    int16_t numRevAfter   = 0;
+
+    if (__get_IPSR() != 0)
+    {
+        return CONTEXT_ERROR;
+    }
+
+    TLE5012_BUS_ACQUIRE(BUS_PRIORITY_CONTROL);
+
+    errorTypes checkError = readAngleRevolution(&numRev);
+    uint8_t    stable     = 0;
+
+    for (uint16_t attempt = 0; attempt < 2 && checkError == NO_ERROR && !stable; attempt++)
+    {
+        checkError = readAngleValue(&rawAngleValue);
+
+        if (checkError == NO_ERROR)
+        {
+            checkError = readAngleRevolution(&numRevAfter);
+        }
+
+        stable = (checkError == NO_ERROR && numRevAfter == numRev);
+        numRev = numRevAfter;
+    }
+
+    TLE5012_BUS_RELEASE();
+
+    if (checkError != NO_ERROR)
+    {
+        return checkError;
+    }
+
+    // the number of revolutions can not change twice during a few reads
+    if (!stable)
+    {
+        return INVALID_ANGLE_ERROR;
+    }
+
+    TLE5012_CRITICAL_ENTER();
+
+    if (!_multiTurnValid)
+    {
+        _multiTurnRevolutions = numRev;
+        _multiTurnValid = 1;
+    }
+    else
+    {
+        // difference modulo 2^9, taken as the shortest way round
+        int16_t delta = (int16_t)((uint16_t)(numRev - _multiTurnLastRev) & DELETE_7BITS);
+
+        if (delta & CHECK_BIT_9)
+        {
+            delta -= CHANGE_UNIT_TO_INT_9;
+        }
+
+        _multiTurnRevolutions += delta;
+    }
+
+    _multiTurnLastRev = numRev;
+    *position = _multiTurnRevolutions * (int32_t)POW_2_15 + rawAngleValue;
+
+    TLE5012_CRITICAL_EXIT();
+
+    return NO_ERROR;
+}
+
+/**
+ * Restarts the multi-turn position from the revolution counter of the sensor at the next getMultiTurnPosition(),
+ * e.g. after the counter was reset or the shaft turned for too long without calls.
+ */
+void resetMultiTurnPosition(void)
+{
+    TLE5012_CRITICAL_ENTER();
+    _multiTurnValid = 0;
+    TLE5012_CRITICAL_EXIT();
+}
+
 errorTypes getTemperature(float32 *temperature)
 {
     int16_t rawTemp = 0;
@@ -654,3 +1411,90 @@ errorTypes getAngleRange(float32 *angleRange)
 
     return NO_ERROR;
 }
+
+void setAdaptiveSampling(const adaptiveSamplingConfig *config)
+{
+    TLE5012_CRITICAL_ENTER();
+    _adaptiveConfig = *config;
+    _adaptiveIdle = 0;
+    _adaptiveStationary = 0;
+    _adaptivePeriod = config->activePeriod;
+    TLE5012_CRITICAL_EXIT();
+}
+
+/**
+ * Reads the angle value and speed, and returns after how long the next sample should be taken.
+ * While the shaft moves the period is activePeriod. When the speed stays below enterIdleSpeed and the angle within angleDeadband
+ * for idleSamples samples, the period is doubled at each sample up to idlePeriod.
+ * As soon as the speed goes above exitIdleSpeed or the angle moves by more than angleDeadband, the period goes back to activePeriod,
+ * so motion is detected at most idlePeriod after it starts, even if it is too short to be seen in the speed.
+ */
+errorTypes getAdaptiveSample(int16_t *rawAngle, uint16_t *nextPeriod)
+{
+    int16_t rawSpeed = 0;
+
+    errorTypes checkError = readAngleSpeed(&rawSpeed);
+
+    if (checkError == NO_ERROR)
+    {
+        checkError = readAngleValue(rawAngle);
+    }
+
+    // the reads are done, only the update of the state is kept away from setAdaptiveSampling() and the other tasks
+    TLE5012_CRITICAL_ENTER();
+
+    if (checkError != NO_ERROR)
+    {
+        _adaptiveIdle = 0;
+        _adaptiveStationary = 0;
+        _adaptivePeriod = _adaptiveConfig.activePeriod;
+    }
+    else
+    {
+        uint16_t speed = (rawSpeed < 0) ? (uint16_t)(-rawSpeed) : (uint16_t)rawSpeed;
+        uint16_t moved = _rawDistance((uint16_t)*rawAngle, (uint16_t)_adaptiveLastAngle, DELETE_BIT_15);
+
+        _adaptiveLastAngle = *rawAngle;
+
+        if (_adaptiveIdle)
+        {
+            if (speed > _adaptiveConfig.exitIdleSpeed || moved > _adaptiveConfig.angleDeadband)
+            {
+                _adaptiveIdle = 0;
+                _adaptiveStationary = 0;
+                _adaptivePeriod = _adaptiveConfig.activePeriod;
+            }
+            else if (_adaptivePeriod < _adaptiveConfig.idlePeriod)
+            {
+                _adaptivePeriod = (_adaptivePeriod > _adaptiveConfig.idlePeriod / 2) ? _adaptiveConfig.idlePeriod : (uint16_t)(_adaptivePeriod * 2 + (_adaptivePeriod == 0));
+            }
+        }
+        else
+        {
+            if (speed < _adaptiveConfig.enterIdleSpeed && moved <= _adaptiveConfig.angleDeadband)
+            {
+                if (++_adaptiveStationary >= _adaptiveConfig.idleSamples)
+                {
+                    _adaptiveIdle = 1;
+                }
+            }
+            else
+            {
+                _adaptiveStationary = 0;
+            }
+
+            _adaptivePeriod = _adaptiveConfig.activePeriod;
+        }
+    }
+
+    *nextPeriod = _adaptivePeriod;
+
+    TLE5012_CRITICAL_EXIT();
+
+    return checkError;
+}
+
+uint8_t getAdaptiveIdle(void)
+{
+    return _adaptiveIdle;
+}
@@ -9,10 +9,18 @@
 #define SPI_CS_DISABLE HAL_GPIO_WritePin(TLE5012_CS_GPIO_Port, TLE5012_CS_Pin, GPIO_PIN_SET)
 
 // Error masks for safety words
+#define CHIP_RESET_MASK             0x8000
 #define SYSTEM_ERROR_MASK           0x4000
 #define INTERFACE_ERROR_MASK        0x2000
 #define INV_ANGLE_ERROR_MASK        0x1000
 
+// register address field of a command word
+#define CMD_ADDRESS_MASK            0x03F0
+#define CMD_ADDRESS_SHIFT           4
+// addresses of the registers which can be read through the fast read path (AVAL, ASPD, AREV)
+#define FAST_READ_FIRST_ADDRESS     0x02
+#define FAST_READ_NUM_REGISTERS     3
+
 // Commands for read
 #define READ_STA_CMD_NOSAFETY       0x8000
 #define READ_STA_CMD                0x8001
@@ -55,6 +63,9 @@
 #define WRITE_INTMODE_4             0x50E1
 #define WRITE_TEMP_COEFF            0x50F1
 
+// writes the 8 _registers used for the CRC (addresses 08 - 0F) in one transaction
+#define WRITE_BLOCK_CRC             0x5088
+
 // mask to check if the command want the value in the register or the value in the update buffer
 #define CHECK_CMD_UPDATE            0x0400
 
@@ -117,6 +128,32 @@
         HAL_GPIO_Init(TLE5012_MOSI_GPIO_Port, &GPIO_InitStruct); \
     } while (0)
 
+#endif
+
+// critical section used for the bookkeeping of the bus arbitration and the driver state shared by the tasks, keeps the previous interrupt state
+#define TLE5012_CRITICAL_ENTER()                 \
+    uint32_t tle5012Primask = __get_PRIMASK();   \
+    __disable_irq()
+
+#define TLE5012_CRITICAL_EXIT() __set_PRIMASK(tle5012Primask)
+
+#ifdef TLE5012_BUS_ARBITRATION
+
+#define TLE5012_BUS_ACQUIRE(priority) busAcquire(priority)
+#define TLE5012_BUS_RELEASE()         _busReleaseSpi()
+
+#else
+
+#define TLE5012_BUS_ACQUIRE(priority) \
+    do                                \
+    {                                 \
+    } while (0)
+
+#define TLE5012_BUS_RELEASE() \
+    do                        \
+    {                         \
+    } while (0)
+
 #endif
 /**
  * This is used for keeping track of which register need to have its value changed, so that you don't need to read all the _registers each time the CRC needs to be updated
@@ -142,11 +179,87 @@ typedef enum errorTypes {
     SYSTEM_ERROR = 0x01,
     INTERFACE_ACCESS_ERROR = 0x02,
     INVALID_ANGLE_ERROR = 0x03,
+    FAST_READ_AUDIT_ERROR = 0x04,
+    CONTEXT_ERROR = 0x05,
+    CHIP_RESET_ERROR = 0x06,
     CRC_ERROR = 0xFF
 } errorTypes;
 
+/**
+ * Counters of the fast read mode, where the angle value, speed and revolution reads skip the safety word
+ */
+typedef struct fastReadStats {
+    uint32_t fastReads;       // reads done without safety word
+    uint32_t audits;          // safety-checked audit reads done
+    uint32_t auditMismatches; // audits whose read without safety word differed from the checked one
+    uint32_t auditErrors;     // audits whose safety word reported an error
+} fastReadStats;
+
+/**
+ * Counters of the chip resets seen in the safety words, and of the restores of the configuration which followed
+ */
+typedef struct chipResetStats {
+    uint32_t resets;          // safety words which reported a chip reset or watchdog overflow
+    uint32_t restores;        // configurations restored and verified
+    uint32_t restoreFailures; // restores whose write or verification failed
+    uint32_t restoresSkipped; // reads refused without a restore attempt after TLE5012_RESTORE_MAX_RETRIES failures
+} chipResetStats;
+
+/**
+ * Settings of the adaptive sampling, which lowers the polling rate while the shaft is stationary.
+ * Speeds and angles are raw sensor values, periods are in the unit of the caller's delay (e.g. ticks of osDelay())
+ */
+typedef struct adaptiveSamplingConfig {
+    uint16_t activePeriod;   // polling period while the shaft moves
+    uint16_t idlePeriod;     // longest polling period at standstill, also the maximum latency to detect motion
+    uint16_t enterIdleSpeed; // angle speed below which the shaft is considered stationary
+    uint16_t exitIdleSpeed;  // angle speed above which the shaft moves again, must be above enterIdleSpeed
+    uint16_t angleDeadband;  // angle change between two samples which counts as motion
+    uint16_t idleSamples;    // number of stationary samples before the polling period starts to grow
+} adaptiveSamplingConfig;
+
+/**
+ * Priorities of the transactions on the shared SPI bus, the lowest value is served first
+ */
+typedef enum busPriority {
+    BUS_PRIORITY_CONTROL = 0,    // angle value, speed and revolutions
+    BUS_PRIORITY_DIAGNOSTIC = 1, // status, temperature and raw values
+    BUS_PRIORITY_CONFIG = 2,     // configuration _registers
+    BUS_NUM_PRIORITIES = 3
+} busPriority;
+
+/**
+ * Contention counters of the shared SPI bus, per priority
+ */
+typedef struct busStats {
+    uint32_t transactions[BUS_NUM_PRIORITIES]; // bus acquisitions
+    uint32_t contended[BUS_NUM_PRIORITIES];    // acquisitions which had to wait for the bus
+    uint32_t queueFull[BUS_NUM_PRIORITIES];    // times the wait queue was full and the task had to retry
+    uint32_t waitTicks[BUS_NUM_PRIORITIES];    // total time spent waiting, in kernel ticks
+    uint32_t maxWaitTicks[BUS_NUM_PRIORITIES]; // longest wait, in kernel ticks
+} busStats;
+
 errorTypes readBlockCRC(void);
+//writes back the _registers read by readBlockCRC() and verifies them
+errorTypes restoreConfiguration(void);
+//returns the counters of the chip resets
+void getChipResetStats(chipResetStats *stats);
 
+//returns the raw angle value, a 15 bit signed integer
+errorTypes readAngleValue(int16_t *data);
+//returns the raw angle speed, a 15 bit signed integer
+errorTypes readAngleSpeed(int16_t *data);
+//returns the raw number of revolutions, a 9 bit signed integer
+errorTypes readAngleRevolution(int16_t *data);
+//returns the raw X value of the GMR bridge, a 16 bit signed integer
+errorTypes readRawX(int16_t *data);
+//returns the raw Y value of the GMR bridge, a 16 bit signed integer
+errorTypes readRawY(int16_t *data);
+
+//returns the position over several turns, 2^15 per turn, extending the 9 bit revolution counter. Task context only
+errorTypes getMultiTurnPosition(int32_t *position);
+//restarts the multi-turn position from the revolution counter of the sensor
+void resetMultiTurnPosition(void);
 //returns the angle speed
 errorTypes getAngleSpeed(float32 *angleSpeed);
 //returns the angleValue
@@ -165,6 +278,28 @@ errorTypes getTemperature(float32 *temp);
 errorTypes getAngleRange(float32 *angleRange);
 //triggers an update in the register
 void triggerUpdate(void);
+//enables or disables reading angle value, speed and revolutions without safety word
+void setFastReadMode(uint8_t enable);
+//returns 1 if the fast read mode is enabled
+uint8_t getFastReadMode(void);
+//returns the counters of the fast read mode
+void getFastReadStats(fastReadStats *stats);
+
+//changes the settings of the adaptive sampling
+void setAdaptiveSampling(const adaptiveSamplingConfig *config);
+//returns the raw angle value and the period to wait before the next call
+errorTypes getAdaptiveSample(int16_t *rawAngle, uint16_t *nextPeriod);
+//returns 1 while the adaptive sampling considers the shaft stationary
+uint8_t getAdaptiveIdle(void);
+
+#ifdef TLE5012_BUS_ARBITRATION
+//waits until the shared SPI bus is free, higher priority tasks are served first. Also used by the other drivers of the bus, only from tasks
+void busAcquire(busPriority priority);
+//gives the shared SPI bus to the highest priority waiting task
+void busRelease(void);
+//returns the contention counters of the shared SPI bus
+void getBusStats(busStats *stats);
+#endif
 
 
 #endif
@@ -13,4 +13,52 @@ typedef float float32;
 #define TLE5012_SPI                 (&hspi2)
 #define TLE5012_MOSI_GPIO_ALTERNATE (GPIO_AF5_SPI2)
 
+// Number of safety-word-less reads allowed between two safety-checked audit reads while the fast read mode is on
+#define TLE5012_FAST_READ_AUDIT_PERIOD    16U
+// Busy-wait loops CS is held low for an update pulse, the sensor needs a few hundred ns
+#define TLE5012_UPDATE_PULSE_LOOPS        8U
+
+// Failed configuration restores in a row after which the checked reads stop retrying at every transaction
+#define TLE5012_RESTORE_MAX_RETRIES       3U
+// Checked reads then refused with CHIP_RESET_ERROR before the next restore attempt
+#define TLE5012_RESTORE_BACKOFF_READS     1000U
+
+// Uncomment when TLE5012_SPI is shared with other devices or the sensor is read from several tasks (needs CMSIS-RTOS2)
+//#define TLE5012_BUS_ARBITRATION
+// Maximum number of tasks waiting for the bus per priority, should be the number of tasks using the bus. When full, a task retries every tick
+#define TLE5012_BUS_QUEUE_DEPTH           4U
+// Thread flag used to hand the bus over to a waiting task, must not be used by the application
+#define TLE5012_BUS_GRANT_FLAG            0x40000000U
+
+// UART used by the binary telemetry stream, see STM32_TLE5012_Telemetry.h
+#define TLE5012_TELEMETRY_UART            (&huart1)
+// Default number of pushed samples per sample sent, can be changed with telemetrySetDecimation()
+#define TLE5012_TELEMETRY_DECIMATION      1U
+// Number of samples packed in one telemetry frame
+#define TLE5012_TELEMETRY_SAMPLES_PER_FRAME 16U
+
+// Default settings of the adaptive sampling, see adaptiveSamplingConfig in STM32_TLE5012B.h
+#define TLE5012_ADAPTIVE_ACTIVE_PERIOD    1U
+#define TLE5012_ADAPTIVE_IDLE_PERIOD      64U
+#define TLE5012_ADAPTIVE_ENTER_IDLE_SPEED 8U
+#define TLE5012_ADAPTIVE_EXIT_IDLE_SPEED  16U
+#define TLE5012_ADAPTIVE_ANGLE_DEADBAND   16U
+#define TLE5012_ADAPTIVE_IDLE_SAMPLES     100U
+
+// Weight of a new sample in the averages of the signal quality monitor, the slow averages use a quarter of it
+#define TLE5012_MONITOR_ALPHA             0.01f
+// Alert limits of the signal quality monitor, see STM32_TLE5012_Monitor.h. Amplitudes depend on the magnet and the air gap
+#define TLE5012_MONITOR_NOISE_LIMIT       25.0f
+#define TLE5012_MONITOR_AMPLITUDE_MIN     4000.0f
+#define TLE5012_MONITOR_AMPLITUDE_MAX     24000.0f
+#define TLE5012_MONITOR_TEMP_MAX          125.0f
+#define TLE5012_MONITOR_TEMP_DRIFT_LIMIT  5.0f
+#define TLE5012_MONITOR_ERROR_RATE_LIMIT  0.01f
+
+// Size of the position threshold table and of the zone event queue, see STM32_TLE5012_Zones.h
+#define TLE5012_ZONE_MAX_THRESHOLDS       64U
+#define TLE5012_ZONE_EVENT_QUEUE_SIZE     16U
+// Orders the memory accesses between an interrupt and a task, emits a DMB on Cortex-M
+#define TLE5012_MEMORY_BARRIER()          __sync_synchronize()
+
 #endif /* INC_STM32_TLE5012_CONFIG_H_ */
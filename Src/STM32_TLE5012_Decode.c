@@ -0,0 +1,180 @@
+/*
+ * STM32_TLE5012_Decode.c
+ *
+ * Batch decoding of raw register words, see STM32_TLE5012_Decode.h.
+ * This file does not depend on the HAL.
+ */
+
+#include "STM32_TLE5012_Decode.h"
+
+/**
+ * CRC of the command followed by one data word, computed bit by bit as in _crc8().
+ */
+uint8_t _decodeCrc(uint16_t command, uint16_t word)
+{
+    uint8_t  data[4] = { (uint8_t)(command >> 8U), (uint8_t)command, (uint8_t)(word >> 8U), (uint8_t)word };
+    uint32_t crc     = CRC_SEED;
+
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        crc ^= data[i];
+
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x80) ? ((crc << 1) ^ CRC_POLYNOMIAL) : (crc << 1);
+        }
+    }
+
+    return (uint8_t)~crc;
+}
+
+/**
+ * With the command fixed, the CRC is an affine function of the 16 data bits: the CRC of a word is the CRC of 0
+ * xor the contribution of each bit set. The contributions are computed once per batch, then each word only needs
+ * shifts, ands and xors, which the compiler vectorizes unlike table lookups.
+ * The error code follows the priority of checkSafety(): system, interface, invalid angle, then CRC, written as arithmetic
+ * on 0/1 flags so there is no branch per word.
+ */
+uint32_t decodeRawValues(uint16_t command, const uint16_t *raw, const uint16_t *safety, uint8_t bits, int16_t *values, uint8_t *status, uint32_t count)
+{
+    uint16_t crcBits[16];
+    uint16_t shift  = (uint16_t)(16 - bits);
+    uint32_t errors = 0;
+
+    uint16_t crcZero = _decodeCrc(command, 0);
+
+    for (uint16_t bit = 0; bit < 16; bit++)
+    {
+        crcBits[bit] = _decodeCrc(command, (uint16_t)(1U << bit)) ^ crcZero;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint16_t word = raw[i];
+        uint16_t safe = safety[i];
+        uint16_t crc  = crcZero;
+
+        for (uint16_t bit = 0; bit < 16; bit++)
+        {
+            crc ^= (uint16_t)(-(uint16_t)((word >> bit) & 1U)) & crcBits[bit];
+        }
+
+        uint16_t systemError    = (uint16_t)(((safe & SYSTEM_ERROR_MASK) == 0));
+        uint16_t interfaceError = (uint16_t)(((safe & INTERFACE_ERROR_MASK) == 0));
+        uint16_t angleError     = (uint16_t)(((safe & INV_ANGLE_ERROR_MASK) == 0));
+        uint16_t crcError       = (uint16_t)((crc != (safe & 0x00FF)));
+
+        uint16_t code = (uint16_t)(systemError * SYSTEM_ERROR
+                                   + (1 - systemError) * (interfaceError * INTERFACE_ACCESS_ERROR
+                                                          + (1 - interfaceError) * (angleError * INVALID_ANGLE_ERROR
+                                                                                    + (1 - angleError) * crcError * CRC_ERROR)));
+
+        // shifting the field to the top and back copies its sign bit, as the subtraction done by the driver
+        int16_t value = (int16_t)((int16_t)(uint16_t)(word << shift) >> shift);
+
+        values[i] = (int16_t)(value & (int16_t)((uint16_t)(code != NO_ERROR) - 1U));
+        status[i] = (uint8_t)code;
+        errors += (code != NO_ERROR);
+    }
+
+    return errors;
+}
+
+uint32_t decodeRawValuesReference(uint16_t command, const uint16_t *raw, const uint16_t *safety, uint8_t bits, int16_t *values, uint8_t *status, uint32_t count)
+{
+    uint16_t deleteBits = (bits == DECODE_BITS_15) ? DELETE_BIT_15 : DELETE_7BITS;
+    uint16_t checkBit   = (bits == DECODE_BITS_15) ? CHECK_BIT_14 : CHECK_BIT_9;
+    uint16_t changeUint = (bits == DECODE_BITS_15) ? CHANGE_UINT_TO_INT_15 : CHANGE_UNIT_TO_INT_9;
+    uint32_t errors     = 0;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint16_t   rawData = raw[i];
+        errorTypes checkError;
+
+        if (!(safety[i] & SYSTEM_ERROR_MASK))
+        {
+            checkError = SYSTEM_ERROR;
+        }
+        else if (!(safety[i] & INTERFACE_ERROR_MASK))
+        {
+            checkError = INTERFACE_ACCESS_ERROR;
+        }
+        else if (!(safety[i] & INV_ANGLE_ERROR_MASK))
+        {
+            checkError = INVALID_ANGLE_ERROR;
+        }
+        else
+        {
+            checkError = (_decodeCrc(command, rawData) == (uint8_t)safety[i]) ? NO_ERROR : CRC_ERROR;
+        }
+
+        status[i] = (uint8_t)checkError;
+
+        if (checkError != NO_ERROR)
+        {
+            values[i] = 0;
+            errors++;
+            continue;
+        }
+
+        rawData = (rawData & deleteBits);
+
+        //check if the value received is positive or negative
+        if (rawData & checkBit)
+        {
+            rawData = rawData - changeUint;
+        }
+
+        values[i] = (int16_t)rawData;
+    }
+
+    return errors;
+}
+
+void decodeAngleToFloat(const int16_t *values, float32 *degrees, uint32_t count)
+{
+    const float32 scale = (float32)(ANGLE_360_VAL / POW_2_15);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        degrees[i] = scale * (float32)values[i];
+    }
+}
+
+/**
+ * One LSB is 360 / 2^15 degrees, which is exactly 720 in 16.16 fixed point.
+ */
+void decodeAngleToQ16(const int16_t *values, int32_t *degrees, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        degrees[i] = (int32_t)values[i] * 720;
+    }
+}
+
+void decodeSpeedToFloat(const int16_t *values, float32 scale, float32 *speeds, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        speeds[i] = scale * (float32)values[i];
+    }
+}
+
+void decodeTemperatureToFloat(const int16_t *values, float32 *temperatures, uint32_t count)
+{
+    const float32 scale = (float32)(1.0 / TEMP_DIV);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        temperatures[i] = ((float32)values[i] + (float32)TEMP_OFFSET) * scale;
+    }
+}
+
+void decodeTemperatureToQ16(const int16_t *values, int32_t *temperatures, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        temperatures[i] = ((int32_t)values[i] + (int32_t)TEMP_OFFSET) * DECODE_TEMP_Q16_SCALE;
+    }
+}
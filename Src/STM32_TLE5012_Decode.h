@@ -0,0 +1,41 @@
+/*
+ * STM32_TLE5012_Decode.h
+ *
+ * Batch decoding of raw register words with their safety words, for host tools and simulators working on captures.
+ * The same masking, sign extension and CRC check as the driver are applied to whole arrays,
+ * with loops without branches in the data path so the compiler can vectorize them.
+ * decodeRawValuesReference() does the same one word at a time like the driver, to compare the results with.
+ */
+
+#ifndef INC_STM32_TLE5012_DECODE_H_
+#define INC_STM32_TLE5012_DECODE_H_
+
+#include <stdint.h>
+
+#include "STM32_TLE5012B.h"
+
+// width of the signed value in a register word
+#define DECODE_BITS_15              15 // AVAL, ASPD
+#define DECODE_BITS_9               9  // AREV, FSYNC (temperature)
+
+// 65536 / TEMP_DIV, used to get the temperature in 16.16 fixed point
+#define DECODE_TEMP_Q16_SCALE       23608
+
+//masks and sign extends count words read with command, checks their safety words and returns the number of words with an error.
+//status[i] gets the errorTypes of the word, values[i] is 0 when there is an error, as done by the driver
+uint32_t decodeRawValues(uint16_t command, const uint16_t *raw, const uint16_t *safety, uint8_t bits, int16_t *values, uint8_t *status, uint32_t count);
+//same as decodeRawValues(), one word at a time with the logic of the driver
+uint32_t decodeRawValuesReference(uint16_t command, const uint16_t *raw, const uint16_t *safety, uint8_t bits, int16_t *values, uint8_t *status, uint32_t count);
+
+//converts decoded angle values to degrees
+void decodeAngleToFloat(const int16_t *values, float32 *degrees, uint32_t count);
+//converts decoded angle values to degrees in 16.16 fixed point, exact
+void decodeAngleToQ16(const int16_t *values, int32_t *degrees, uint32_t count);
+//converts decoded angle speeds with the factor returned for one LSB by the speed formula of the driver
+void decodeSpeedToFloat(const int16_t *values, float32 scale, float32 *speeds, uint32_t count);
+//converts decoded temperatures to degrees Celsius
+void decodeTemperatureToFloat(const int16_t *values, float32 *temperatures, uint32_t count);
+//converts decoded temperatures to degrees Celsius in 16.16 fixed point
+void decodeTemperatureToQ16(const int16_t *values, int32_t *temperatures, uint32_t count);
+
+#endif /* INC_STM32_TLE5012_DECODE_H_ */
@@ -0,0 +1,143 @@
+/*
+ * STM32_TLE5012_Monitor.c
+ *
+ * Online signal quality monitor, see STM32_TLE5012_Monitor.h.
+ */
+
+#include <math.h>
+
+#include "STM32_TLE5012_Monitor.h"
+
+// the slow averages used for the temperature drift follow changes four times slower
+#define MONITOR_SLOW_ALPHA (TLE5012_MONITOR_ALPHA / 4.0f)
+
+qualityStats _quality;
+float32      _qualityAngleMean = 0.0f;
+float32      _qualitySlowTemperature = 0.0f;
+int16_t      _qualityAngleReference = 0;
+uint8_t      _qualityAngleValid = 0; // 1 while the shaft stays stationary and the reference is set
+uint8_t      _qualityAmplitudeValid = 0;
+uint8_t      _qualityTemperatureValid = 0;
+
+void qualityMonitorInit(void)
+{
+    _quality = (qualityStats){ 0 };
+    _qualityAngleMean = 0.0f;
+    _qualitySlowTemperature = 0.0f;
+    _qualityAngleValid = 0;
+    _qualityAmplitudeValid = 0;
+    _qualityTemperatureValid = 0;
+}
+
+/**
+ * The noise is estimated around the first stationary angle value, wrapped to 15 bits,
+ * so the average and variance stay small numbers even near the 0/360 degrees transition.
+ * While the shaft moves the variance estimate is kept as it is.
+ */
+void qualityMonitorAddAngle(int16_t rawAngle, uint8_t stationary)
+{
+    _quality.samples++;
+
+    if (!stationary)
+    {
+        _qualityAngleValid = 0;
+        return;
+    }
+
+    if (!_qualityAngleValid)
+    {
+        _qualityAngleReference = rawAngle;
+        _qualityAngleMean = 0.0f;
+        _qualityAngleValid = 1;
+        return;
+    }
+
+    // 15 bit signed difference from the reference, as done for the raw angle value
+    int16_t difference = (int16_t)((uint16_t)(rawAngle - _qualityAngleReference) << 1) >> 1;
+    float32 deviation  = (float32)difference - _qualityAngleMean;
+
+    _qualityAngleMean += TLE5012_MONITOR_ALPHA * deviation;
+    _quality.angleNoiseVariance = (1.0f - TLE5012_MONITOR_ALPHA) * (_quality.angleNoiseVariance + TLE5012_MONITOR_ALPHA * deviation * deviation);
+}
+
+void qualityMonitorAddRawXY(int16_t rawX, int16_t rawY)
+{
+    float32 amplitude = sqrtf((float32)rawX * (float32)rawX + (float32)rawY * (float32)rawY);
+
+    if (!_qualityAmplitudeValid)
+    {
+        _quality.amplitude = amplitude;
+        _quality.minAmplitude = amplitude;
+        _qualityAmplitudeValid = 1;
+        return;
+    }
+
+    _quality.amplitude += TLE5012_MONITOR_ALPHA * (amplitude - _quality.amplitude);
+
+    if (_quality.amplitude < _quality.minAmplitude)
+    {
+        _quality.minAmplitude = _quality.amplitude;
+    }
+}
+
+void qualityMonitorAddTemperature(float32 temperature)
+{
+    if (!_qualityTemperatureValid)
+    {
+        _quality.temperature = temperature;
+        _qualitySlowTemperature = temperature;
+        _qualityTemperatureValid = 1;
+        return;
+    }
+
+    _quality.temperature += TLE5012_MONITOR_ALPHA * (temperature - _quality.temperature);
+    _qualitySlowTemperature += MONITOR_SLOW_ALPHA * (temperature - _qualitySlowTemperature);
+    _quality.temperatureDrift = _quality.temperature - _qualitySlowTemperature;
+}
+
+void qualityMonitorAddStatus(errorTypes status)
+{
+    _quality.errorRate += TLE5012_MONITOR_ALPHA * (((status != NO_ERROR) ? 1.0f : 0.0f) - _quality.errorRate);
+}
+
+uint16_t qualityMonitorAlerts(void)
+{
+    uint16_t alerts = 0;
+
+    if (_quality.angleNoiseVariance > TLE5012_MONITOR_NOISE_LIMIT)
+    {
+        alerts |= QUALITY_ALERT_ANGLE_NOISE;
+    }
+
+    if (_qualityAmplitudeValid && _quality.amplitude < TLE5012_MONITOR_AMPLITUDE_MIN)
+    {
+        alerts |= QUALITY_ALERT_AMPLITUDE_LOW;
+    }
+
+    if (_qualityAmplitudeValid && _quality.amplitude > TLE5012_MONITOR_AMPLITUDE_MAX)
+    {
+        alerts |= QUALITY_ALERT_AMPLITUDE_HIGH;
+    }
+
+    if (_qualityTemperatureValid && _quality.temperature > TLE5012_MONITOR_TEMP_MAX)
+    {
+        alerts |= QUALITY_ALERT_TEMPERATURE_HIGH;
+    }
+
+    if (fabsf(_quality.temperatureDrift) > TLE5012_MONITOR_TEMP_DRIFT_LIMIT)
+    {
+        alerts |= QUALITY_ALERT_TEMPERATURE_DRIFT;
+    }
+
+    if (_quality.errorRate > TLE5012_MONITOR_ERROR_RATE_LIMIT)
+    {
+        alerts |= QUALITY_ALERT_ERROR_RATE;
+    }
+
+    return alerts;
+}
+
+void qualityMonitorGetStats(qualityStats *stats)
+{
+    *stats = _quality;
+}
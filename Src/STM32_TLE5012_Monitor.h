@@ -0,0 +1,52 @@
+/*
+ * STM32_TLE5012_Monitor.h
+ *
+ * Signal quality monitor: follows the angle noise at standstill, the amplitude of the raw X/Y values,
+ * the temperature and the rate of errors with exponential averages, so it uses constant memory and no extra reads.
+ * The values are passed by the application from the reads it already does, at whatever rate each one is read.
+ */
+
+#ifndef INC_STM32_TLE5012_MONITOR_H_
+#define INC_STM32_TLE5012_MONITOR_H_
+
+#include <stdint.h>
+
+#include "STM32_TLE5012B.h"
+
+// Alert bits returned by qualityMonitorAlerts()
+#define QUALITY_ALERT_ANGLE_NOISE       0x0001
+#define QUALITY_ALERT_AMPLITUDE_LOW     0x0002
+#define QUALITY_ALERT_AMPLITUDE_HIGH    0x0004
+#define QUALITY_ALERT_TEMPERATURE_HIGH  0x0008
+#define QUALITY_ALERT_TEMPERATURE_DRIFT 0x0010
+#define QUALITY_ALERT_ERROR_RATE        0x0020
+
+/**
+ * Current estimates of the monitor
+ */
+typedef struct qualityStats {
+    float32  angleNoiseVariance; // variance of the raw angle value at standstill, in LSB^2
+    float32  amplitude;          // average amplitude of the raw X/Y values
+    float32  minAmplitude;       // lowest average amplitude seen
+    float32  temperature;        // average temperature, in degrees
+    float32  temperatureDrift;   // difference between the fast and the slow temperature average, in degrees
+    float32  errorRate;          // average fraction of reads which returned an error
+    uint32_t samples;            // number of angle values added
+} qualityStats;
+
+//resets all the estimates
+void qualityMonitorInit(void);
+//adds a raw angle value, stationary is 1 if the shaft is not moving (e.g. getAdaptiveIdle())
+void qualityMonitorAddAngle(int16_t rawAngle, uint8_t stationary);
+//adds the raw X and Y values of the GMR bridges
+void qualityMonitorAddRawXY(int16_t rawX, int16_t rawY);
+//adds a temperature returned by getTemperature()
+void qualityMonitorAddTemperature(float32 temperature);
+//adds the result of a read
+void qualityMonitorAddStatus(errorTypes status);
+//returns the QUALITY_ALERT_ bits of the estimates which are out of their limits
+uint16_t qualityMonitorAlerts(void);
+//returns the current estimates
+void qualityMonitorGetStats(qualityStats *stats);
+
+#endif /* INC_STM32_TLE5012_MONITOR_H_ */
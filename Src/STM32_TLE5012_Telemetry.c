@@ -0,0 +1,180 @@
+/*
+ * STM32_TLE5012_Telemetry.c
+ *
+ * Packs the raw samples in frames and sends them with DMA on TLE5012_TELEMETRY_UART,
+ * the frame layout is described in STM32_TLE5012_Telemetry.h.
+ */
+
+#include "STM32_TLE5012_Telemetry.h"
+#include "main.h"
+#include "usart.h"
+
+// number of encoded frames which can wait for the UART, one is sent while the other one is filled
+#define TELEMETRY_TX_BUFFERS 2
+
+uint8_t  _telemetryFrame[TELEMETRY_FRAME_SIZE];
+uint8_t  _telemetryTx[TELEMETRY_TX_BUFFERS][TELEMETRY_ENCODED_SIZE];
+uint16_t _telemetryTxLength[TELEMETRY_TX_BUFFERS];
+uint8_t  _telemetryTxFirst = 0;   // oldest encoded frame
+uint8_t  _telemetryTxCount = 0;   // encoded frames waiting or being sent
+uint8_t  _telemetryTxBusy  = 0;   // 1 while the oldest frame is being sent
+
+uint16_t _telemetrySequence     = 0;
+uint32_t _telemetrySampleIndex  = 0;
+uint16_t _telemetryDecimation   = TLE5012_TELEMETRY_DECIMATION;
+uint16_t _telemetryDecimateLeft = 0;
+uint8_t  _telemetryFrameSamples = 0;
+
+telemetryStats _telemetryStats;
+
+void _putUint16(uint8_t *buffer, uint16_t value)
+{
+    buffer[0] = (uint8_t)value;
+    buffer[1] = (uint8_t)(value >> 8U);
+}
+
+/**
+ * Frees the frame sent by the DMA and starts the next one. Called from the sampling context and from the UART interrupt,
+ * so the bookkeeping is done with the interrupts disabled.
+ * Only the transmit state is checked: HAL_UART_GetState() also reports reception, and would never be ready
+ * while the UART is receiving.
+ */
+void _telemetryKick(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (_telemetryTxBusy && TLE5012_TELEMETRY_UART->gState == HAL_UART_STATE_READY)
+    {
+        _telemetryTxBusy = 0;
+        _telemetryTxFirst = (_telemetryTxFirst + 1) % TELEMETRY_TX_BUFFERS;
+        _telemetryTxCount--;
+        _telemetryStats.framesSent++;
+    }
+
+    if (!_telemetryTxBusy && _telemetryTxCount > 0 && TLE5012_TELEMETRY_UART->gState == HAL_UART_STATE_READY)
+    {
+        if (HAL_UART_Transmit_DMA(TLE5012_TELEMETRY_UART, _telemetryTx[_telemetryTxFirst], _telemetryTxLength[_telemetryTxFirst]) == HAL_OK)
+        {
+            _telemetryTxBusy = 1;
+        }
+    }
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * Adds the CRC to the frame being filled, encodes it in a free buffer and queues it for the DMA.
+ */
+void _telemetryCloseFrame(void)
+{
+    uint16_t length = TELEMETRY_HEADER_SIZE + _telemetryFrameSamples * TELEMETRY_SAMPLE_SIZE;
+
+    _telemetryFrame[9] = _telemetryFrameSamples;
+    _putUint16(&_telemetryFrame[length], telemetryCrc16(_telemetryFrame, length));
+    length += TELEMETRY_CRC_SIZE;
+
+    _telemetryFrameSamples = 0;
+    _telemetrySequence++;
+
+    // the UART interrupt moves _telemetryTxFirst and _telemetryTxCount together, so both are read at once
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint8_t count = _telemetryTxCount;
+    uint8_t index = (_telemetryTxFirst + count) % TELEMETRY_TX_BUFFERS;
+    __set_PRIMASK(primask);
+
+    if (count >= TELEMETRY_TX_BUFFERS)
+    {
+        _telemetryStats.framesDropped++;
+        return;
+    }
+
+    // only the sampling context adds frames, so the free buffer can be filled with the interrupts enabled
+    uint16_t encoded = telemetryCobsEncode(_telemetryFrame, length, _telemetryTx[index]);
+
+    _telemetryTx[index][encoded] = TELEMETRY_FRAME_DELIMITER;
+    _telemetryTxLength[index] = encoded + 1;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    _telemetryTxCount++;
+    __set_PRIMASK(primask);
+}
+
+void telemetryInit(void)
+{
+    _telemetryTxFirst = 0;
+    _telemetryTxCount = 0;
+    _telemetryTxBusy = 0;
+    _telemetrySequence = 0;
+    _telemetrySampleIndex = 0;
+    _telemetryDecimateLeft = 0;
+    _telemetryFrameSamples = 0;
+    _telemetryStats = (telemetryStats){ 0 };
+}
+
+void telemetrySetDecimation(uint16_t decimation)
+{
+    _telemetryDecimation = decimation ? decimation : 1;
+    _telemetryDecimateLeft = 0;
+
+    // a frame only holds samples with the same decimation
+    if (_telemetryFrameSamples > 0)
+    {
+        _telemetryCloseFrame();
+    }
+}
+
+/**
+ * Adds a sample to the stream. Only one sample out of the decimation is packed,
+ * the frame is queued for the DMA when it holds TLE5012_TELEMETRY_SAMPLES_PER_FRAME samples.
+ */
+void telemetryPushSample(const telemetrySample *sample)
+{
+    uint32_t sampleIndex = _telemetrySampleIndex++;
+
+    if (_telemetryDecimateLeft > 0)
+    {
+        _telemetryDecimateLeft--;
+        _telemetryKick();
+        return;
+    }
+
+    _telemetryDecimateLeft = _telemetryDecimation - 1;
+
+    if (_telemetryFrameSamples == 0)
+    {
+        _telemetryFrame[0] = TELEMETRY_FRAME_VERSION;
+        _putUint16(&_telemetryFrame[1], _telemetrySequence);
+        _putUint16(&_telemetryFrame[3], (uint16_t)sampleIndex);
+        _putUint16(&_telemetryFrame[5], (uint16_t)(sampleIndex >> 16U));
+        _putUint16(&_telemetryFrame[7], _telemetryDecimation);
+    }
+
+    uint8_t *packed = &_telemetryFrame[TELEMETRY_HEADER_SIZE + _telemetryFrameSamples * TELEMETRY_SAMPLE_SIZE];
+
+    _putUint16(&packed[0], (uint16_t)sample->rawAngle);
+    _putUint16(&packed[2], (uint16_t)sample->rawSpeed);
+    _putUint16(&packed[4], (uint16_t)sample->revolutions);
+    packed[6] = sample->status;
+
+    _telemetryStats.samplesSent++;
+
+    if (++_telemetryFrameSamples >= TLE5012_TELEMETRY_SAMPLES_PER_FRAME)
+    {
+        _telemetryCloseFrame();
+    }
+
+    _telemetryKick();
+}
+
+void telemetryTxComplete(void)
+{
+    _telemetryKick();
+}
+
+void telemetryGetStats(telemetryStats *stats)
+{
+    *stats = _telemetryStats;
+}
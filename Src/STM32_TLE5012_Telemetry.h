@@ -0,0 +1,76 @@
+/*
+ * STM32_TLE5012_Telemetry.h
+ *
+ * Binary telemetry stream of raw sensor samples over UART, sent with DMA.
+ *
+ * Frame layout before encoding, all fields little endian:
+ * 0      - frame version, TELEMETRY_FRAME_VERSION
+ * 1:2    - frame sequence number, a gap means frames were dropped
+ * 3:6    - index of the first sample of the frame, counting every pushed sample (before decimation)
+ * 7:8    - decimation, number of pushed samples per sample sent
+ * 9      - number of samples in the frame
+ * 10:... - samples, TELEMETRY_SAMPLE_SIZE bytes each: raw angle value, raw angle speed, revolutions (int16) and error code
+ * last 2 - CRC-16/CCITT of all the previous bytes
+ *
+ * The frame is then COBS encoded, so it contains no zero byte, and terminated with TELEMETRY_FRAME_DELIMITER.
+ */
+
+#ifndef INC_STM32_TLE5012_TELEMETRY_H_
+#define INC_STM32_TLE5012_TELEMETRY_H_
+
+#include <stdint.h>
+
+#include "STM32_TLE5012_Config.h"
+
+#define TELEMETRY_FRAME_VERSION     0x01
+#define TELEMETRY_FRAME_DELIMITER   0x00
+#define TELEMETRY_HEADER_SIZE       10
+#define TELEMETRY_SAMPLE_SIZE       7
+#define TELEMETRY_CRC_SIZE          2
+
+// values used for calculating the CRC of a frame
+#define TELEMETRY_CRC_POLYNOMIAL    0x1021
+#define TELEMETRY_CRC_SEED          0xFFFF
+
+#define TELEMETRY_FRAME_SIZE        (TELEMETRY_HEADER_SIZE + TLE5012_TELEMETRY_SAMPLES_PER_FRAME * TELEMETRY_SAMPLE_SIZE + TELEMETRY_CRC_SIZE)
+// COBS adds one byte per 254 bytes of data plus one, then comes the delimiter
+#define TELEMETRY_ENCODED_SIZE      (TELEMETRY_FRAME_SIZE + TELEMETRY_FRAME_SIZE / 254 + 2)
+
+/**
+ * One raw sample of the sensor, as returned by readAngleValue(), readAngleSpeed() and readAngleRevolution()
+ */
+typedef struct telemetrySample {
+    int16_t rawAngle;
+    int16_t rawSpeed;
+    int16_t revolutions;
+    uint8_t status;      // errorTypes of the reads
+} telemetrySample;
+
+/**
+ * Counters of the telemetry stream
+ */
+typedef struct telemetryStats {
+    uint32_t samplesSent;
+    uint32_t framesSent;
+    uint32_t framesDropped; // frames lost because the UART was still busy with the previous ones
+} telemetryStats;
+
+//resets the stream, to be called after the UART is initialized
+void telemetryInit(void);
+//sets the number of pushed samples per sample sent
+void telemetrySetDecimation(uint16_t decimation);
+//adds a sample to the stream, to be called at the sampling rate
+void telemetryPushSample(const telemetrySample *sample);
+//starts the transfer of a pending frame, to be called from HAL_UART_TxCpltCallback()
+void telemetryTxComplete(void);
+//returns the counters of the stream
+void telemetryGetStats(telemetryStats *stats);
+
+//CRC of a frame, also used by the host decoder
+uint16_t telemetryCrc16(const uint8_t *data, uint16_t length);
+//COBS encodes length bytes of data into encoded, returns the encoded length
+uint16_t telemetryCobsEncode(const uint8_t *data, uint16_t length, uint8_t *encoded);
+//COBS decodes length bytes of encoded (without delimiter) into data, returns the decoded length or 0 if it is malformed
+uint16_t telemetryCobsDecode(const uint8_t *encoded, uint16_t length, uint8_t *data);
+
+#endif /* INC_STM32_TLE5012_TELEMETRY_H_ */
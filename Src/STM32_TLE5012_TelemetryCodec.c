@@ -0,0 +1,100 @@
+/*
+ * STM32_TLE5012_TelemetryCodec.c
+ *
+ * CRC and COBS framing of the telemetry stream. This file does not depend on the HAL,
+ * so it is shared by the firmware and the host decoder.
+ */
+
+#include "STM32_TLE5012_Telemetry.h"
+
+/**
+ * Function for calculation the CRC-16/CCITT of a frame.
+ */
+uint16_t telemetryCrc16(const uint8_t *data, uint16_t length)
+{
+    uint16_t crc = TELEMETRY_CRC_SEED;
+
+    for (uint16_t i = 0; i < length; i++)
+    {
+        crc ^= (uint16_t)data[i] << 8U;
+
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            if ((crc & 0x8000) != 0)
+            {
+                crc = (uint16_t)(crc << 1) ^ TELEMETRY_CRC_POLYNOMIAL;
+            }
+            else
+            {
+                crc <<= 1;
+            }
+        }
+    }
+
+    return crc;
+}
+
+/**
+ * Consistent overhead byte stuffing: every zero byte is replaced by the distance to the next one,
+ * so TELEMETRY_FRAME_DELIMITER can only appear between frames.
+ */
+uint16_t telemetryCobsEncode(const uint8_t *data, uint16_t length, uint8_t *encoded)
+{
+    uint16_t codeIndex = 0;
+    uint16_t out       = 1;
+    uint8_t  code      = 1;
+
+    for (uint16_t i = 0; i < length; i++)
+    {
+        if (data[i] == 0)
+        {
+            encoded[codeIndex] = code;
+            codeIndex = out++;
+            code = 1;
+        }
+        else
+        {
+            encoded[out++] = data[i];
+            code++;
+
+            if (code == 0xFF)
+            {
+                encoded[codeIndex] = code;
+                codeIndex = out++;
+                code = 1;
+            }
+        }
+    }
+
+    encoded[codeIndex] = code;
+
+    return out;
+}
+
+uint16_t telemetryCobsDecode(const uint8_t *encoded, uint16_t length, uint8_t *data)
+{
+    uint16_t in  = 0;
+    uint16_t out = 0;
+
+    while (in < length)
+    {
+        uint8_t code = encoded[in++];
+
+        if (code == 0 || in + code - 1 > length)
+        {
+            return 0;
+        }
+
+        for (uint8_t i = 1; i < code; i++)
+        {
+            data[out++] = encoded[in++];
+        }
+
+        if (code != 0xFF && in < length)
+        {
+            data[out++] = 0;
+        }
+    }
+
+    return out;
+}
@@ -0,0 +1,295 @@
+/*
+ * STM32_TLE5012_Zones.c
+ *
+ * Position thresholds and zones, see STM32_TLE5012_Zones.h.
+ * The table is changed from the application and read from the acquisition context,
+ * so thresholds should be added while zoneUpdate() is not running.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "STM32_TLE5012_Zones.h"
+
+typedef struct zoneThreshold {
+    int32_t  level;
+    uint16_t hysteresis;
+    uint16_t id;
+    uint8_t  kind;
+} zoneThreshold;
+
+zoneThreshold _zoneTable[TLE5012_ZONE_MAX_THRESHOLDS];
+uint16_t      _zoneCount = 0;
+uint16_t      _zoneIndex = 0;    // number of thresholds below the position
+uint8_t       _zoneSynced = 0;   // 0 until the first sample after zoneClear()
+int32_t       _zonePosition = 0; // position of the last sample
+zoneCallback  _zoneCallback = NULL;
+
+// single producer (zoneUpdate) single consumer (zoneGetEvent) queue
+zoneEvent         _zoneQueue[TLE5012_ZONE_EVENT_QUEUE_SIZE];
+volatile uint16_t _zoneQueueHead = 0;
+volatile uint16_t _zoneQueueTail = 0;
+uint32_t          _zoneLostEvents = 0;
+
+void zoneClear(void)
+{
+    _zoneCount = 0;
+    _zoneIndex = 0;
+    _zoneSynced = 0;
+    _zoneQueueTail = _zoneQueueHead;
+    _zoneLostEvents = 0;
+}
+
+/**
+ * Inserts a threshold at its place in the table. The neighbours must be far enough for the hysteresis bands not to overlap,
+ * otherwise a sample could be on both sides of two thresholds at the same time.
+ */
+uint16_t _zoneInsert(int32_t level, uint16_t hysteresis, uint16_t id, uint8_t kind)
+{
+    uint16_t place = 0;
+
+    if (_zoneCount >= TLE5012_ZONE_MAX_THRESHOLDS)
+    {
+        return 0;
+    }
+
+    while (place < _zoneCount && _zoneTable[place].level < level)
+    {
+        place++;
+    }
+
+    if (place > 0 && level - _zoneTable[place - 1].level <= (int32_t)hysteresis + _zoneTable[place - 1].hysteresis)
+    {
+        return 0;
+    }
+
+    if (place < _zoneCount && _zoneTable[place].level - level <= (int32_t)hysteresis + _zoneTable[place].hysteresis)
+    {
+        return 0;
+    }
+
+    memmove(&_zoneTable[place + 1], &_zoneTable[place], (_zoneCount - place) * sizeof(zoneThreshold));
+
+    _zoneTable[place].level = level;
+    _zoneTable[place].hysteresis = hysteresis;
+    _zoneTable[place].id = id;
+    _zoneTable[place].kind = kind;
+    _zoneCount++;
+
+    // keep the index on the last position, without event: zoneIsInside() tells where the position is
+    if (place < _zoneIndex || (place == _zoneIndex && _zoneSynced && level <= _zonePosition))
+    {
+        _zoneIndex++;
+    }
+
+    return _zoneCount;
+}
+
+void _zoneRemove(uint16_t place)
+{
+    memmove(&_zoneTable[place], &_zoneTable[place + 1], (_zoneCount - place - 1) * sizeof(zoneThreshold));
+    _zoneCount--;
+
+    if (place < _zoneIndex)
+    {
+        _zoneIndex--;
+    }
+}
+
+uint8_t zoneAddThreshold(int32_t level, uint16_t hysteresis, uint16_t id)
+{
+    return _zoneInsert(level, hysteresis, id, ZONE_THRESHOLD) != 0;
+}
+
+uint8_t zoneAddRange(int32_t lower, int32_t upper, uint16_t hysteresis, uint16_t id)
+{
+    if (upper <= lower || _zoneCount + 2U > TLE5012_ZONE_MAX_THRESHOLDS)
+    {
+        return 0;
+    }
+
+    if (!_zoneInsert(lower, hysteresis, id, ZONE_LOWER_LIMIT))
+    {
+        return 0;
+    }
+
+    if (!_zoneInsert(upper, hysteresis, id, ZONE_UPPER_LIMIT))
+    {
+        // take the lower limit out again, it is the only threshold with this level
+        uint16_t place = 0;
+
+        while (_zoneTable[place].level != lower)
+        {
+            place++;
+        }
+
+        _zoneRemove(place);
+        return 0;
+    }
+
+    return 1;
+}
+
+void zoneSetCallback(zoneCallback callback)
+{
+    _zoneCallback = callback;
+}
+
+void _zoneFire(const zoneThreshold *threshold, uint8_t up, int32_t position)
+{
+    zoneEvent event;
+
+    event.id = threshold->id;
+    event.position = position;
+
+    if (threshold->kind == ZONE_LOWER_LIMIT)
+    {
+        event.type = up ? ZONE_ENTER : ZONE_EXIT;
+    }
+    else if (threshold->kind == ZONE_UPPER_LIMIT)
+    {
+        event.type = up ? ZONE_EXIT : ZONE_ENTER;
+    }
+    else
+    {
+        event.type = up ? ZONE_CROSSED_UP : ZONE_CROSSED_DOWN;
+    }
+
+    if (_zoneCallback != NULL)
+    {
+        _zoneCallback(&event);
+        return;
+    }
+
+    uint16_t next = (_zoneQueueHead + 1) % TLE5012_ZONE_EVENT_QUEUE_SIZE;
+
+    if (next == _zoneQueueTail)
+    {
+        _zoneLostEvents++;
+        return;
+    }
+
+    _zoneQueue[_zoneQueueHead] = event;
+    // the event must be stored before the consumer sees the new head
+    TLE5012_MEMORY_BARRIER();
+    _zoneQueueHead = next;
+}
+
+/**
+ * Place of the upper limit of the zone whose lower limit is at place, the limits of a zone have the same id.
+ */
+uint16_t _zoneFindUpper(uint16_t place)
+{
+    uint16_t upper = place + 1;
+
+    while (upper < _zoneCount && !(_zoneTable[upper].kind == ZONE_UPPER_LIMIT && _zoneTable[upper].id == _zoneTable[place].id))
+    {
+        upper++;
+    }
+
+    return upper;
+}
+
+/**
+ * The first sample sets the index with a binary search and fires ZONE_ENTER for every zone containing the position,
+ * so an axis starting inside a zone reports it. Then the index only moves by the thresholds actually crossed,
+ * firing one event for each of them.
+ */
+void zoneUpdate(int32_t position)
+{
+    _zonePosition = position;
+
+    if (!_zoneSynced)
+    {
+        uint16_t low  = 0;
+        uint16_t high = _zoneCount;
+
+        while (low < high)
+        {
+            uint16_t middle = (low + high) / 2;
+
+            if (_zoneTable[middle].level <= position)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+
+        _zoneIndex = low;
+        _zoneSynced = 1;
+
+        for (uint16_t place = 0; place < _zoneIndex; place++)
+        {
+            if (_zoneTable[place].kind == ZONE_LOWER_LIMIT && _zoneFindUpper(place) >= _zoneIndex)
+            {
+                _zoneFire(&_zoneTable[place], 1, position);
+            }
+        }
+
+        return;
+    }
+
+    while (_zoneIndex < _zoneCount && position >= _zoneTable[_zoneIndex].level + _zoneTable[_zoneIndex].hysteresis)
+    {
+        _zoneFire(&_zoneTable[_zoneIndex], 1, position);
+        _zoneIndex++;
+    }
+
+    while (_zoneIndex > 0 && position < _zoneTable[_zoneIndex - 1].level - _zoneTable[_zoneIndex - 1].hysteresis)
+    {
+        _zoneIndex--;
+        _zoneFire(&_zoneTable[_zoneIndex], 0, position);
+    }
+}
+
+/**
+ * A zone is entered when its lower limit is below the index and its upper limit is not, a threshold is passed when it is below the index.
+ */
+uint8_t zoneIsInside(uint16_t id)
+{
+    if (!_zoneSynced)
+    {
+        return 0;
+    }
+
+    for (uint16_t place = 0; place < _zoneCount; place++)
+    {
+        if (_zoneTable[place].id != id || _zoneTable[place].kind == ZONE_UPPER_LIMIT)
+        {
+            continue;
+        }
+
+        if (_zoneTable[place].kind == ZONE_THRESHOLD)
+        {
+            return place < _zoneIndex;
+        }
+
+        return place < _zoneIndex && _zoneFindUpper(place) >= _zoneIndex;
+    }
+
+    return 0;
+}
+
+uint8_t zoneGetEvent(zoneEvent *event)
+{
+    if (_zoneQueueTail == _zoneQueueHead)
+    {
+        return 0;
+    }
+
+    TLE5012_MEMORY_BARRIER();
+    *event = _zoneQueue[_zoneQueueTail];
+    // the event must be copied before the producer can reuse its slot
+    TLE5012_MEMORY_BARRIER();
+    _zoneQueueTail = (_zoneQueueTail + 1) % TLE5012_ZONE_EVENT_QUEUE_SIZE;
+
+    return 1;
+}
+
+uint32_t zoneGetLostEvents(void)
+{
+    return _zoneLostEvents;
+}
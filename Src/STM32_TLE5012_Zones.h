@@ -0,0 +1,64 @@
+/*
+ * STM32_TLE5012_Zones.h
+ *
+ * Position thresholds and zones evaluated right after each sample, in the acquisition task.
+ * Positions are multi-turn raw values as returned by getMultiTurnPosition(), 2^15 per turn.
+ *
+ * The thresholds are kept sorted by position, and the index of the position in the table is kept between samples,
+ * so a sample which crosses no threshold costs two comparisons whatever the size of the table.
+ * A threshold is crossed upwards when the position reaches level + hysteresis, and downwards when it goes below level - hysteresis.
+ * The hysteresis bands of two thresholds must not overlap.
+ */
+
+#ifndef INC_STM32_TLE5012_ZONES_H_
+#define INC_STM32_TLE5012_ZONES_H_
+
+#include <stdint.h>
+
+#include "STM32_TLE5012B.h"
+
+// converts an angle in degrees to a position
+#define ZONE_POSITION_FROM_DEGREES(degrees) ((int32_t)((degrees) * (POW_2_15 / ANGLE_360_VAL)))
+
+/**
+ * What a threshold is used for, which gives the type of its events
+ */
+typedef enum zoneThresholdKind {
+    ZONE_THRESHOLD = 0,   // single threshold
+    ZONE_LOWER_LIMIT = 1, // lower limit of a zone
+    ZONE_UPPER_LIMIT = 2, // upper limit of a zone
+} zoneThresholdKind;
+
+typedef enum zoneEventType {
+    ZONE_CROSSED_UP = 0,
+    ZONE_CROSSED_DOWN = 1,
+    ZONE_ENTER = 2,
+    ZONE_EXIT = 3,
+} zoneEventType;
+
+typedef struct zoneEvent {
+    uint16_t id;       // id given when adding the threshold or zone
+    uint8_t  type;     // zoneEventType
+    int32_t  position; // position of the sample which fired the event
+} zoneEvent;
+
+typedef void (*zoneCallback)(const zoneEvent *event);
+
+//removes all the thresholds and events
+void zoneClear(void);
+//adds a threshold, returns 0 if the table is full or the hysteresis overlaps another threshold
+uint8_t zoneAddThreshold(int32_t level, uint16_t hysteresis, uint16_t id);
+//adds a zone between two positions, returns 0 if the table is full or the hysteresis overlaps another threshold
+uint8_t zoneAddRange(int32_t lower, int32_t upper, uint16_t hysteresis, uint16_t id);
+//calls callback from zoneUpdate() for each event instead of queuing it, NULL to queue the events
+void zoneSetCallback(zoneCallback callback);
+//evaluates the thresholds for a new sample, to be called right after each sample. The first sample fires ZONE_ENTER for the zones containing it
+void zoneUpdate(int32_t position);
+//returns 1 while the position is inside the zone id, or above the threshold id
+uint8_t zoneIsInside(uint16_t id);
+//gets the oldest queued event, returns 0 if there is none
+uint8_t zoneGetEvent(zoneEvent *event);
+//returns the number of events lost because the queue was full
+uint32_t zoneGetLostEvents(void);
+
+#endif /* INC_STM32_TLE5012_ZONES_H_ */
@@ -0,0 +1,49 @@
+/*
+ * main.h
+ *
+ * Host stand-in for the CubeMX main.h, with only what STM32_TLE5012_Telemetry.c uses,
+ * so the telemetry packer can be built and tested on the host by Tools/test_telemetry_pty.py.
+ */
+
+#ifndef HOST_MAIN_H_
+#define HOST_MAIN_H_
+
+#include <stdint.h>
+
+typedef enum
+{
+    HAL_OK      = 0x00,
+    HAL_ERROR   = 0x01,
+    HAL_BUSY    = 0x02,
+    HAL_TIMEOUT = 0x03
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+    HAL_UART_STATE_READY   = 0x20,
+    HAL_UART_STATE_BUSY_TX = 0x21
+} HAL_UART_StateTypeDef;
+
+typedef struct
+{
+    volatile HAL_UART_StateTypeDef gState;
+} UART_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size);
+
+// there is a single context on the host, the critical sections have nothing to mask
+static inline uint32_t __get_PRIMASK(void)
+{
+    return 0;
+}
+
+static inline void __set_PRIMASK(uint32_t priMask)
+{
+    (void)priMask;
+}
+
+static inline void __disable_irq(void)
+{
+}
+
+#endif /* HOST_MAIN_H_ */
@@ -0,0 +1,110 @@
+/*
+ * telemetry_sender.c
+ *
+ * Runs STM32_TLE5012_Telemetry.c on the host, with a UART whose DMA writes the frames to stdout,
+ * for Tools/test_telemetry_pty.py.
+ *
+ * Pushes frames * decimation * TLE5012_TELEMETRY_SAMPLES_PER_FRAME samples. The DMA completes after each push,
+ * except while the samples of the frames [stall, stall + 3) are pushed: the UART stays busy with the first
+ * frame closed in that window, the next one waits in the second buffer and the one after is dropped.
+ * The counters of the stream are printed on stderr.
+ *
+ * Usage: telemetry_sender frames decimation stall > /dev/pts/N
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "STM32_TLE5012_Telemetry.h"
+#include "usart.h"
+
+UART_HandleTypeDef huart1 = { HAL_UART_STATE_READY };
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+    if (huart->gState != HAL_UART_STATE_READY)
+    {
+        return HAL_BUSY;
+    }
+
+    while (Size > 0)
+    {
+        ssize_t written = write(STDOUT_FILENO, pData, Size);
+
+        if (written <= 0)
+        {
+            return HAL_ERROR;
+        }
+
+        pData += written;
+        Size -= (uint16_t)written;
+    }
+
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+
+    return HAL_OK;
+}
+
+/**
+ * Samples cycle through values whose bytes are terminal control characters (CR, LF, 0x03, 0x04, XON/XOFF...),
+ * the test computes the same values from the index.
+ */
+void makeSample(uint32_t index, telemetrySample *sample)
+{
+    static const uint16_t special[] = { 0x0D0A, 0x0304, 0x1113, 0x7F1A, 0x1C15 };
+
+    sample->rawAngle = (int16_t)(special[index % 5] - 0x8000 * (index % 2));
+    sample->rawSpeed = (int16_t)(-(int32_t)index);
+    sample->revolutions = (int16_t)(index / 100);
+    sample->status = (uint8_t)(index % 4);
+}
+
+void txComplete(void)
+{
+    huart1.gState = HAL_UART_STATE_READY;
+    telemetryTxComplete();
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 4)
+    {
+        fprintf(stderr, "usage: %s frames decimation stall\n", argv[0]);
+        return 2;
+    }
+
+    uint32_t frames = (uint32_t)atoi(argv[1]);
+    uint32_t decimation = (uint32_t)atoi(argv[2]);
+    uint32_t stall = (uint32_t)atoi(argv[3]);
+    uint32_t perFrame = decimation * TLE5012_TELEMETRY_SAMPLES_PER_FRAME;
+
+    telemetryInit();
+    telemetrySetDecimation((uint16_t)decimation);
+
+    for (uint32_t index = 0; index < frames * perFrame; index++)
+    {
+        telemetrySample sample;
+
+        makeSample(index, &sample);
+        telemetryPushSample(&sample);
+
+        if (index / perFrame < stall || index / perFrame >= stall + 3)
+        {
+            txComplete();
+        }
+    }
+
+    // let the DMA finish the frames still waiting
+    for (uint16_t i = 0; i < 4; i++)
+    {
+        txComplete();
+    }
+
+    telemetryStats stats;
+    telemetryGetStats(&stats);
+    fprintf(stderr, "samples %lu sent %lu dropped %lu\n", (unsigned long)stats.samplesSent, (unsigned long)stats.framesSent,
+            (unsigned long)stats.framesDropped);
+
+    return 0;
+}
@@ -0,0 +1,14 @@
+/*
+ * usart.h
+ *
+ * Host stand-in for the CubeMX usart.h, see main.h.
+ */
+
+#ifndef HOST_USART_H_
+#define HOST_USART_H_
+
+#include "main.h"
+
+extern UART_HandleTypeDef huart1;
+
+#endif /* HOST_USART_H_ */
@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+"""
+Round trip test of the telemetry stream through a pseudo-terminal, standing in for the UART.
+
+Builds tle5012_telemetry_decode, and Tools/host/telemetry_sender.c with the firmware packer and encoder
+(STM32_TLE5012_Telemetry.c, STM32_TLE5012_TelemetryCodec.c). The sender pushes samples containing the bytes
+a terminal in cooked mode would change (CR, LF, 0x03, 0x04, XON/XOFF...) with a decimation, and keeps the UART
+busy long enough to drop a frame. Its frames are written to the master side of a pty left in its default mode,
+and the CSV printed by the decoder reading the slave side is checked against the samples.
+
+Usage: python3 Tools/test_telemetry_pty.py
+"""
+
+import fcntl
+import os
+import pty
+import struct
+import subprocess
+import sys
+import tempfile
+import termios
+import time
+
+TOOLS = os.path.dirname(os.path.abspath(__file__))
+SRC = os.path.join(TOOLS, "..", "Src")
+HOST = os.path.join(TOOLS, "host")
+
+SAMPLES_PER_FRAME = 16
+DECIMATION = 3
+NUM_FRAMES = 20
+STALLED_FRAME = 6
+# the UART stays busy with STALLED_FRAME, the next frame waits in the second buffer and the one after is dropped
+DROPPED_FRAME = STALLED_FRAME + 2
+
+
+def sample(index):
+    # same values as makeSample() in Tools/host/telemetry_sender.c
+    special = [0x0D0A, 0x0304, 0x1113, 0x7F1A, 0x1C15]
+    angle = special[index % len(special)] - 0x8000 * (index % 2)
+    return angle, -index, index // 100, index % 4
+
+
+def expected_samples():
+    expected = []
+    for sequence in range(NUM_FRAMES):
+        if sequence == DROPPED_FRAME:
+            continue
+        first = sequence * SAMPLES_PER_FRAME * DECIMATION
+        for i in range(SAMPLES_PER_FRAME):
+            index = first + i * DECIMATION
+            expected.append((index,) + sample(index))
+    return expected
+
+
+def build(build_dir, name, sources, includes):
+    binary = os.path.join(build_dir, name)
+    subprocess.check_call(["cc", "-O2", "-Wall"] + ["-I" + path for path in includes] + ["-o", binary] + sources)
+    return binary
+
+
+def main():
+    build_dir = tempfile.mkdtemp()
+    codec = os.path.join(SRC, "STM32_TLE5012_TelemetryCodec.c")
+    decoder = build(build_dir, "tle5012_telemetry_decode",
+                    [os.path.join(TOOLS, "tle5012_telemetry_decode.c"), codec], [SRC])
+    sender = build(build_dir, "telemetry_sender",
+                   [os.path.join(HOST, "telemetry_sender.c"), os.path.join(SRC, "STM32_TLE5012_Telemetry.c"), codec],
+                   [HOST, SRC])
+
+    master, slave = pty.openpty()
+    slave_path = os.ttyname(slave)
+
+    process = subprocess.Popen([decoder, "-r", "1000", "-b", "115200", slave_path],
+                               stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+
+    # the stream must only be written once the decoder has put the terminal in raw mode
+    deadline = time.time() + 5
+    while termios.tcgetattr(master)[3] & termios.ICANON:
+        if time.time() > deadline:
+            process.kill()
+            sys.exit("decoder did not switch the terminal to raw mode")
+        time.sleep(0.01)
+
+    # a partial frame before the first delimiter, as when the decoder starts in the middle of the stream
+    os.write(master, b"\x03\x04 partial frame\x00")
+    result = subprocess.run([sender, str(NUM_FRAMES), str(DECIMATION), str(STALLED_FRAME)],
+                            stdout=master, stderr=subprocess.PIPE, timeout=10)
+    sender_stats = result.stderr.decode().strip()
+    expected = expected_samples()
+
+    # wait until the decoder has read everything before hanging up
+    deadline = time.time() + 5
+    while struct.unpack("i", fcntl.ioctl(slave, termios.FIONREAD, b"\0\0\0\0"))[0] > 0 and time.time() < deadline:
+        time.sleep(0.01)
+    time.sleep(0.2)
+    os.close(slave)
+    os.close(master)
+
+    out, err = process.communicate(timeout=5)
+    lines = out.decode().splitlines()[1:]
+    decoded = []
+    for line in lines:
+        index, _, degrees, speed, revolutions, status = line.split(",")
+        decoded.append((int(index), round(float(degrees) * 32768.0 / 360.0), int(speed), int(revolutions), int(status)))
+
+    failures = []
+    if decoded != expected:
+        failures.append("decoded %d samples, expected %d, first difference at %s" % (
+            len(decoded), len(expected),
+            next((i for i, (a, b) in enumerate(zip(decoded, expected)) if a != b), min(len(decoded), len(expected)))))
+    summary = "frames: %d ok, 1 bad, 1 lost" % (NUM_FRAMES - 1)
+    if summary not in err.decode():
+        failures.append("expected '%s', got '%s'" % (summary, err.decode().strip()))
+    stats = "samples %d sent %d dropped 1" % (NUM_FRAMES * SAMPLES_PER_FRAME, NUM_FRAMES - 1)
+    if result.returncode != 0 or sender_stats != stats:
+        failures.append("expected sender '%s', got '%s'" % (stats, sender_stats))
+
+    if failures:
+        sys.exit("FAIL: " + "; ".join(failures))
+
+    print("PASS: %d samples through %s, %s" % (len(decoded), slave_path, err.decode().strip()))
+
+
+if __name__ == "__main__":
+    main()
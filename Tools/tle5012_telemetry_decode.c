@@ -0,0 +1,253 @@
+/*
+ * tle5012_telemetry_decode.c
+ *
+ * Host decoder of the binary telemetry stream sent by STM32_TLE5012_Telemetry.c.
+ * Reads the stream from a serial port, a pseudo-terminal, a capture file or stdin,
+ * and prints the reconstructed time series as CSV.
+ *
+ * A serial port or pseudo-terminal is switched to raw mode, at the baud rate given with -b,
+ * so the line discipline does not change the binary stream (CR to LF, 0x03 as interrupt, 0x04 as end of file...).
+ *
+ * Build: cc -O2 -I../Src -o tle5012_telemetry_decode tle5012_telemetry_decode.c ../Src/STM32_TLE5012_TelemetryCodec.c
+ * Usage: tle5012_telemetry_decode [-r sample_rate_hz] [-b baud] [input]
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "STM32_TLE5012_Telemetry.h"
+
+// values used to convert the raw angle value to degrees, as in getAngleValue()
+#define POW_2_15      32768.0
+#define ANGLE_360_VAL 360.0
+
+typedef struct decoderState {
+    double   sampleRate;
+    uint8_t  synced;        // 1 after the first valid frame
+    uint16_t nextSequence;
+    uint32_t framesOk;
+    uint32_t framesBad;     // frames with a wrong length or CRC
+    uint32_t framesLost;    // frames missing from the sequence numbers
+} decoderState;
+
+static uint16_t getUint16(const uint8_t *buffer)
+{
+    return (uint16_t)(buffer[0] | (buffer[1] << 8U));
+}
+
+static void decodeFrame(decoderState *state, const uint8_t *encoded, uint16_t encodedLength)
+{
+    uint8_t  frame[TELEMETRY_ENCODED_SIZE];
+    uint16_t length = telemetryCobsDecode(encoded, encodedLength, frame);
+
+    if (length < TELEMETRY_HEADER_SIZE + TELEMETRY_CRC_SIZE || frame[0] != TELEMETRY_FRAME_VERSION)
+    {
+        state->framesBad++;
+        return;
+    }
+
+    uint8_t numSamples = frame[9];
+
+    if (length != TELEMETRY_HEADER_SIZE + numSamples * TELEMETRY_SAMPLE_SIZE + TELEMETRY_CRC_SIZE
+        || telemetryCrc16(frame, length - TELEMETRY_CRC_SIZE) != getUint16(&frame[length - TELEMETRY_CRC_SIZE]))
+    {
+        state->framesBad++;
+        return;
+    }
+
+    uint16_t sequence    = getUint16(&frame[1]);
+    uint32_t sampleIndex = getUint16(&frame[3]) | ((uint32_t)getUint16(&frame[5]) << 16U);
+    uint16_t decimation  = getUint16(&frame[7]);
+
+    if (state->synced && sequence != state->nextSequence)
+    {
+        state->framesLost += (uint16_t)(sequence - state->nextSequence);
+    }
+
+    state->synced = 1;
+    state->nextSequence = sequence + 1;
+    state->framesOk++;
+
+    for (uint8_t i = 0; i < numSamples; i++)
+    {
+        const uint8_t *packed = &frame[TELEMETRY_HEADER_SIZE + i * TELEMETRY_SAMPLE_SIZE];
+        uint32_t       index  = sampleIndex + (uint32_t)i * decimation;
+        int16_t        angle  = (int16_t)getUint16(&packed[0]);
+
+        printf("%lu,%.6f,%.4f,%d,%d,%u\n",
+               (unsigned long)index,
+               index / state->sampleRate,
+               (ANGLE_360_VAL / POW_2_15) * angle,
+               (int16_t)getUint16(&packed[2]),
+               (int16_t)getUint16(&packed[4]),
+               packed[6]);
+    }
+}
+
+static speed_t baudToSpeed(long baud)
+{
+    switch (baud)
+    {
+    case 9600: return B9600;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+#ifdef B460800
+    case 460800: return B460800;
+#endif
+#ifdef B921600
+    case 921600: return B921600;
+#endif
+#ifdef B1000000
+    case 1000000: return B1000000;
+#endif
+#ifdef B2000000
+    case 2000000: return B2000000;
+#endif
+    default: return B0;
+    }
+}
+
+/**
+ * Switches a terminal to raw mode at the given baud rate, the previous settings are kept in saved.
+ * Returns 0 if the input is not a terminal, 1 if it was switched, -1 on error.
+ */
+static int setRawMode(FILE *input, speed_t speed, struct termios *saved)
+{
+    struct termios settings;
+    int            fd = fileno(input);
+
+    if (!isatty(fd))
+    {
+        return 0;
+    }
+
+    if (tcgetattr(fd, saved) != 0)
+    {
+        perror("tcgetattr");
+        return -1;
+    }
+
+    settings = *saved;
+    cfmakeraw(&settings);
+    settings.c_cc[VMIN] = 1;
+    settings.c_cc[VTIME] = 0;
+    cfsetispeed(&settings, speed);
+    cfsetospeed(&settings, speed);
+
+    if (tcsetattr(fd, TCSANOW, &settings) != 0)
+    {
+        perror("tcsetattr");
+        return -1;
+    }
+
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    decoderState   state = { 0 };
+    const char    *path  = NULL;
+    FILE          *input = stdin;
+    speed_t        speed = B115200;
+    struct termios saved;
+
+    state.sampleRate = 1.0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            state.sampleRate = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+        {
+            speed = baudToSpeed(atol(argv[++i]));
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
+    if (state.sampleRate <= 0.0 || speed == B0)
+    {
+        fprintf(stderr, "usage: %s [-r sample_rate_hz] [-b baud] [input]\n", argv[0]);
+        return 2;
+    }
+
+    if (path != NULL)
+    {
+        // a terminal must not become the controlling terminal of the decoder
+        int fd = open(path, O_RDONLY | O_NOCTTY);
+
+        if (fd < 0 || (input = fdopen(fd, "rb")) == NULL)
+        {
+            perror(path);
+            return 1;
+        }
+    }
+
+    int rawMode = setRawMode(input, speed, &saved);
+
+    if (rawMode < 0)
+    {
+        return 1;
+    }
+
+    uint8_t  encoded[TELEMETRY_ENCODED_SIZE];
+    uint16_t encodedLength = 0;
+    uint8_t  overflow      = 0;
+    int      c;
+
+    printf("sample,time_s,angle_deg,raw_speed,revolutions,status\n");
+
+    while ((c = fgetc(input)) != EOF)
+    {
+        if (c == TELEMETRY_FRAME_DELIMITER)
+        {
+            if (overflow)
+            {
+                state.framesBad++;
+            }
+            else if (encodedLength > 0)
+            {
+                decodeFrame(&state, encoded, encodedLength);
+            }
+
+            encodedLength = 0;
+            overflow = 0;
+        }
+        else if (encodedLength < sizeof(encoded))
+        {
+            encoded[encodedLength++] = (uint8_t)c;
+        }
+        else
+        {
+            overflow = 1;
+        }
+    }
+
+    fprintf(stderr, "frames: %lu ok, %lu bad, %lu lost\n",
+            (unsigned long)state.framesOk, (unsigned long)state.framesBad, (unsigned long)state.framesLost);
+
+    if (rawMode > 0)
+    {
+        tcsetattr(fileno(input), TCSANOW, &saved);
+    }
+
+    if (input != stdin)
+    {
+        fclose(input);
+    }
+
+    return 0;
+}